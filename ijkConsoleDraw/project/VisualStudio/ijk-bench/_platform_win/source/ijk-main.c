@@ -0,0 +1,87 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijk-main.c
+	Console application entry point for benchmarks.
+*/
+
+#include "ijk/ijk/ijk-typedefs.h"
+
+#if ijk_platform_is(WINDOWS)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// application entry point
+
+iret main(
+	i32 const		argc,
+	kstr const		argv[])
+{
+	iret ijkPlayerBenchmark(kstr const args);
+
+	// rejoin arguments into one command line, as the player receives it; 
+	//	arguments holding spaces are quoted again (quotes cannot be passed)
+	char* args;
+	size_t length = 0, size;
+	bool quoted;
+	i32 i;
+	for (i = 1; i < argc; ++i)
+	{
+		if (strchr(argv[i], '"'))
+		{
+			fprintf(stderr, "argument %d: quotes are not supported\n", i);
+			return ijk_failcode(ijk_fail_invalidparam);
+		}
+		length += strlen(argv[i]) + 3;
+	}
+	args = (char*)malloc(length + 1);
+	if (!args)
+		return ijk_failcode(ijk_fail_allocation);
+	for (i = 1, length = 0; i < argc; ++i)
+	{
+		size = strlen(argv[i]);
+		quoted = !size || strpbrk(argv[i], " \t") != 0;
+		if (quoted)
+			args[length++] = '"';
+		memcpy(args + length, argv[i], size);
+		length += size;
+		if (quoted)
+			args[length++] = '"';
+		args[length++] = ' ';
+	}
+	args[length] = 0;
+
+	iret status = ijkPlayerBenchmark(args);
+	free(args);
+
+	// the end
+	return status;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
@@ -0,0 +1,158 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijk-main.c
+	Console application entry point for frame capture: reference consumer 
+		of the player's frame ring, writing each frame as a PPM image.
+*/
+
+#include "../../../../../source/ijk-player/common/_util/ijkRing.h"
+#include "../../../../../source/ijk-player/common/_util/ijkThread.h"
+
+#if ijk_platform_is(WINDOWS)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <io.h>
+#include <fcntl.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Color of each console color index, as red, green, blue
+static byte const capturePalette[16][3] = {
+	{ 0, 0, 0 }, { 0, 0, 128 }, { 0, 128, 0 }, { 0, 128, 128 },
+	{ 128, 0, 0 }, { 128, 0, 128 }, { 128, 128, 0 }, { 192, 192, 192 },
+	{ 128, 128, 128 }, { 0, 0, 255 }, { 0, 255, 0 }, { 0, 255, 255 },
+	{ 255, 0, 0 }, { 255, 0, 255 }, { 255, 255, 0 }, { 255, 255, 255 },
+};
+
+// Keep first ring file found
+static bool captureFind(kstr const path, ptr const args)
+{
+	strncpy((char*)args, path, 255);
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// application entry point
+
+//	-> arguments: ring file, or directory holding one ("-" or none is the 
+//		shared directory); output prefix ("-" streams images to standard 
+//		output; default "frame"); frames to capture (0 or none until the 
+//		player stops)
+iret main(
+	i32 const		argc,
+	kstr const		argv[])
+{
+	kstr const source = (argc > 1 && strcmp(argv[1], "-")) ? argv[1] : ijkMapGetSharedDirectory();
+	kstr const prefix = argc > 2 ? argv[2] : "frame";
+	ui32 const count = argc > 3 ? (ui32)strtoul(argv[3], 0, 10) : 0;
+	ijkRingFile file = { 0 };
+	char path[256] = "";
+	byte const* cells;
+	byte* image;
+	FILE* out;
+	ui32 frame, captured = 0, skipped = 0, i, n;
+	i32 sequence, next = 1;
+	bool closed;
+
+	// source is a ring file, or else a directory to search for one
+	if (!ijk_issuccess(ijkRingOpen(&file, source)))
+	{
+		ijkMapFind(source, ijkRingPrefix, captureFind, path);
+		if (!path[0] || !ijk_issuccess(ijkRingOpen(&file, path)))
+		{
+			fprintf(stderr, "no frame ring in '%s'\n", source);
+			return ijk_failcode(ijk_fail_invalidparam);
+		}
+	}
+	n = (ui32)file.ring->width * (ui32)file.ring->height;
+	image = (byte*)malloc((size_t)n * 3);
+	if (!image)
+	{
+		ijkRingRelease(&file);
+		return ijk_failcode(ijk_fail_allocation);
+	}
+
+	// images are binary: streamed ones must not pass through text mode
+	if (!strcmp(prefix, "-"))
+		_setmode(_fileno(stdout), _O_BINARY);
+
+	//------------------------------------
+	while (!count || captured < count)
+	{
+		// frames published before the producer closed are still taken
+		closed = ijkThreadAtomicLoad(&file.ring->closed) != 0;
+		sequence = ijkRingReadBegin(file.ring, next, &cells, &frame);
+		if (!sequence)
+		{
+			if (closed)
+				break;
+			ijkThreadSleep(1);
+			continue;
+		}
+
+		// cells are read in place, then kept only if the slot held still
+		for (i = 0; i < n; ++i)
+			memcpy(image + i * 3, capturePalette[cells[i] & 0xf], 3);
+		skipped += (ui32)(sequence - next);
+		next = sequence + 1;
+		if (!ijkRingReadEnd(file.ring, sequence))
+		{
+			++skipped;
+			continue;
+		}
+
+		if (strcmp(prefix, "-"))
+		{
+			sprintf(path, "%.200s-%06u.ppm", prefix, frame);
+			out = fopen(path, "wb");
+		}
+		else
+			out = stdout;
+		if (!out)
+			break;
+		fprintf(out, "P6\n%u %u\n255\n", (ui32)file.ring->width, (ui32)file.ring->height);
+		fwrite(image, 3, n, out);
+		if (out != stdout)
+			fclose(out);
+		else
+			fflush(out);
+		++captured;
+	}
+	//------------------------------------
+
+	fprintf(stderr, "%u frames captured, %u skipped\n", captured, skipped);
+	free(image);
+	ijkRingRelease(&file);
+
+	// the end
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
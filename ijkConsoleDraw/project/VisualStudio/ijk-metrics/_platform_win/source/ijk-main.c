@@ -0,0 +1,60 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijk-main.c
+	Console application entry point for metrics reader: writes metrics 
+		published by every running player in Prometheus text format.
+*/
+
+#include "../../../../../source/ijk-player/common/_util/ijkMetrics.h"
+
+#if ijk_platform_is(WINDOWS)
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// application entry point
+
+iret main(
+	i32 const		argc,
+	kstr const		argv[])
+{
+	// directory is the one players publish to with "--metrics dir" 
+	//	("-" or none is the shared directory)
+	kstr const directory = (argc > 1 && strcmp(argv[1], "-")) ? argv[1] : ijkMapGetSharedDirectory();
+	ui32 count = 0;
+
+	iret status = ijkMetricsWrite(stdout, directory, &count);
+	if (!ijk_issuccess(status))
+		fprintf(stderr, "could not search '%s'\n", directory);
+	else if (!count)
+		fprintf(stderr, "no players publishing in '%s'\n", directory);
+
+	// the end
+	return status;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
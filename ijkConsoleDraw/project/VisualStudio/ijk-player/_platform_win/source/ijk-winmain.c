@@ -39,9 +39,9 @@ iret __stdcall WinMain(
 	kstr const		lpCmdLine,
 	i32 const		nCmdShow)
 {
-	iret ijkPlayerMain();
+	iret ijkPlayerMain(kstr const args);
 
-	iret status = ijkPlayerMain();
+	iret status = ijkPlayerMain(lpCmdLine);
 
 	// the end
 	return status;
@@ -0,0 +1,101 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijk-main.c
+	Console application entry point for scene conversion: text scene
+		descriptions to binary scene files, which the player maps with
+		"--load"; also checks and times loading binary scene files.
+*/
+
+#include "../../../../../source/ijk-player/common/_util/scene.h"
+#include "../../../../../source/ijk-player/common/_util/ijkTimer.h"
+
+#if ijk_platform_is(WINDOWS)
+
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// application entry point
+
+//	-> arguments: text scene and binary scene file to write; or binary
+//		scene file alone, which is loaded (checksum included) and reported
+iret main(
+	i32 const		argc,
+	kstr const		argv[])
+{
+	sScene scene = { 0 };
+	ijkTimer timer[1];
+	f64 ms;
+	ui32 line;
+
+	if (argc < 2 || !ijk_issuccess(ijkTimerInit(timer)))
+	{
+		fprintf(stderr, "usage: ijk-scene scene.txt scene.bin | ijk-scene scene.bin\n");
+		return ijk_failcode(ijk_fail_invalidparam);
+	}
+
+	//------------------------------------
+	ijkTimerStart(timer);
+	if (argc > 2)
+	{
+		if (!fSceneParse(&scene, argv[1], &line))
+		{
+			if (line)
+				fprintf(stderr, "%s(%u): not a scene item\n", argv[1], line);
+			else
+				fprintf(stderr, "%s: could not read scene (or no light)\n", argv[1]);
+			return ijk_failcode(ijk_fail_invalidparam);
+		}
+		ms = ijkTimerLap(timer) * 1000.0;
+		if (!fSceneSave(&scene, argv[2]))
+		{
+			fprintf(stderr, "%s: could not write scene\n", argv[2]);
+			fSceneRelease(&scene);
+			return ijk_failcode(ijk_fail_invalidparam);
+		}
+		printf("%s: %u spheres, %u cylinders, %u lights; parsed in %.3f ms, written in %.3f ms\n",
+			argv[2], scene.numSpheres, scene.numCylinders, scene.numPointLights, ms, ijkTimerElapsed(timer) * 1000.0);
+	}
+	else
+	{
+		if (!fSceneLoad(&scene, argv[1]))
+		{
+			fprintf(stderr, "%s: not a binary scene file of this layout, or damaged\n", argv[1]);
+			return ijk_failcode(ijk_fail_invalidparam);
+		}
+		printf("%s: %u spheres, %u cylinders, %u lights, %llu bytes; loaded in %.3f ms\n",
+			argv[1], scene.numSpheres, scene.numCylinders, scene.numPointLights,
+			(unsigned long long)scene.size, ijkTimerElapsed(timer) * 1000.0);
+	}
+	//------------------------------------
+
+	fSceneRelease(&scene);
+
+	// the end
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
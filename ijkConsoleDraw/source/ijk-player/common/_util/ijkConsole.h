@@ -252,6 +252,16 @@ iret ijkConsoleDrawTestPatch();
 //		return FAILURE: ijk_fail_specified if operation failed
 iret ijkConsoleClear();
 
+// ijkConsoleGetKey
+//	Wait for and read key from console input as soon as it is pressed, 
+//		without echo; redirected input is read as a stream.
+//		param key_out: pointer to value to store character read (EOF at end)
+//			valid: non-null
+//		return SUCCESS: ijk_success if operation succeeded
+//		return FAILURE: ijk_fail_specified if operation failed
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkConsoleGetKey(i32* const key_out);
+
 
 //-----------------------------------------------------------------------------
 
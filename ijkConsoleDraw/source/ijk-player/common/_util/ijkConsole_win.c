@@ -435,6 +435,32 @@ iret ijkConsoleClear()
 }
 
 
+iret ijkConsoleGetKey(i32* const key_out)
+{
+	ijk_assertparamptr(key_out);
+
+	// redirected input has no console mode
+	HANDLE const stdHandle = GetStdHandle(STD_INPUT_HANDLE);
+	dword mode[1] = { 0 }, read[1] = { 0 };
+	if (!stdHandle || stdHandle == INVALID_HANDLE_VALUE || !GetConsoleMode(stdHandle, mode))
+	{
+		*key_out = getchar();
+		return ijk_success;
+	}
+
+	// line input off (echo depends on it) so the read returns on key press
+	char key = 0;
+	bln completed = SetConsoleMode(stdHandle, *mode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT));
+	ijk_assertspectrue(completed, ijk_fail_console_manip);
+	completed = ReadConsoleA(stdHandle, &key, 1, read, 0);
+	SetConsoleMode(stdHandle, *mode);
+	ijk_assertspectrue(completed, ijk_fail_console_manip);
+
+	*key_out = *read ? (i32)(byte)key : EOF;
+	return ijk_success;
+}
+
+
 //-----------------------------------------------------------------------------
 
 iret ijkConsolePrintDebug(kstr const format, ...)
@@ -0,0 +1,108 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkHistogram.c
+	Fixed-precision value histogram source.
+*/
+
+#include "ijkHistogram.h"
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Sub-buckets per power of two
+#define ijkHistogramSub				(1 << ijkHistogramSubBits)
+
+// Get bucket of value
+//	-> values below twice the sub-buckets are their own bucket; above,
+//		each power of two is split into the sub-buckets, by the value's
+//		top bits after shifting out the rest
+static ui32 ijkHistogramIndex(ui64 const value)
+{
+	ui32 shift = 0;
+	if (value < 2 * ijkHistogramSub)
+		return (ui32)value;
+	while (value >> (shift + ijkHistogramSubBits + 1))
+		++shift;
+	return ((shift << ijkHistogramSubBits) + (ui32)(value >> shift));
+}
+
+// Get largest value in bucket
+static ui64 ijkHistogramValue(ui32 const index)
+{
+	ui32 shift;
+	if (index < 2 * ijkHistogramSub)
+		return index;
+	shift = (index >> ijkHistogramSubBits) - 1;
+	return (((ui64)(index - (shift << ijkHistogramSubBits)) + 1) << shift) - 1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkHistogramReset(ijkHistogram* const histogram)
+{
+	ijk_assertparamptr(histogram);
+
+	memset(histogram, 0, sizeof(*histogram));
+	return ijk_success;
+}
+
+
+iret ijkHistogramRecord(ijkHistogram* const histogram, ui64 const value)
+{
+	ui64 const clamped = ijk_minimum(value, ((ui64)1 << ijkHistogramBits) - 1);
+	ijk_assertparamptr(histogram);
+
+	if (!histogram->count || clamped < histogram->min)
+		histogram->min = clamped;
+	if (!histogram->count || clamped > histogram->max)
+		histogram->max = clamped;
+	++histogram->count;
+	histogram->sum += (f64)clamped;
+	++histogram->bucket[ijkHistogramIndex(clamped)];
+	return ijk_success;
+}
+
+
+ui64 ijkHistogramPercentile(ijkHistogram const* const histogram, f64 const percentile)
+{
+	ui64 rank, seen;
+	ui32 i;
+	if (!histogram || !histogram->count || percentile < 0.0 || percentile > 100.0)
+		return 0;
+
+	// smallest rank covering share, at least the first value
+	rank = (ui64)(percentile * 0.01 * (f64)histogram->count + 0.9999999);
+	rank = ijk_maximum(rank, 1);
+	for (i = 0, seen = 0; i < ijkHistogramBuckets; ++i)
+	{
+		seen += histogram->bucket[i];
+		if (seen >= rank)
+			return ijk_minimum(ijkHistogramValue(i), histogram->max);
+	}
+	return histogram->max;
+}
+
+
+//-----------------------------------------------------------------------------
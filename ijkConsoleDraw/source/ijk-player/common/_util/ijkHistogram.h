@@ -0,0 +1,104 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkHistogram.h
+	Fixed-precision value histogram interface (HDR-style): buckets are
+		exact for small values, then log-linear, so every value is kept
+		to within the same relative precision.
+*/
+
+#ifndef _IJK_HISTOGRAM_H_
+#define _IJK_HISTOGRAM_H_
+
+#include "ijk/ijk/ijk-typedefs.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// ijkHistogramSubBits
+//	Sub-buckets per power of two, as bits; values are kept to within one
+//		part in this many (64: under 1.6%).
+#define ijkHistogramSubBits			6
+
+// ijkHistogramBits
+//	Bits of largest value kept; larger values are clamped.
+#define ijkHistogramBits			40
+
+// ijkHistogramBuckets
+//	Buckets per histogram: exact values below twice the sub-buckets, then
+//		one run of sub-buckets per further power of two.
+#define ijkHistogramBuckets			((ijkHistogramBits - ijkHistogramSubBits + 1) << ijkHistogramSubBits)
+
+// ijkHistogram
+//	Descriptor for histogram of values.
+IJK_DECL_STRUCT(ijkHistogram)
+{
+	ui64 count;					// Values recorded.
+	ui64 min, max;				// Smallest and largest values recorded (exact).
+	f64 sum;					// Sum of values recorded.
+	ui32 bucket[ijkHistogramBuckets];	// Values recorded per bucket.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkHistogramReset
+//	Remove all values from histogram.
+//		param histogram: pointer to descriptor that stores histogram
+//			valid: non-null
+//		return SUCCESS: ijk_success if histogram reset
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkHistogramReset(ijkHistogram* const histogram);
+
+// ijkHistogramRecord
+//	Add value to histogram.
+//		param histogram: pointer to descriptor that stores histogram
+//			valid: non-null
+//		param value: value recorded (clamped to largest value kept)
+//		return SUCCESS: ijk_success if value recorded
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkHistogramRecord(ijkHistogram* const histogram, ui64 const value);
+
+// ijkHistogramPercentile
+//	Get value at or below which given share of recorded values fall.
+//		param histogram: pointer to descriptor that stores histogram
+//			valid: non-null
+//		param percentile: share of values in percent
+//			valid: [0, 100]
+//		return: largest value in bucket holding percentile, at most the
+//			largest value recorded; zero if none or invalid parameters
+ui64 ijkHistogramPercentile(ijkHistogram const* const histogram, f64 const percentile);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_HISTOGRAM_H_
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkMap.h
+	Memory-mapped file interface.
+*/
+
+#ifndef _IJK_MAP_H_
+#define _IJK_MAP_H_
+
+#include "ijk/ijk/ijk-typedefs.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkMap)
+{
+	ijk_fail_map_open,		// Failure with map file open or create.
+	ijk_fail_map_view,		// Failure with map view of file.
+	ijk_fail_map_find,		// Failure with map directory search.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkMap
+//	Descriptor for file mapped into memory.
+IJK_DECL_STRUCT(ijkMap)
+{
+	ptr handle[2];				// Internal handle data.
+	byte* data;					// Start of mapped file; null if not mapped.
+	size_t size;				// Bytes mapped.
+	bool writable;				// Mapped for writing (shared with other processes).
+};
+
+// ijkMapFindFunc
+//	Function called per file found.
+//		param path: path of file found
+//		param args: pointer passed to search
+//		return: true to continue search
+typedef bool(*ijkMapFindFunc)(kstr const path, ptr const args);
+
+
+//-----------------------------------------------------------------------------
+
+// ijkMapCreate
+//	Create file (replacing any) of given size and map it for writing;
+//		contents start zeroed.
+//		param map: pointer to descriptor that stores map info
+//			valid: non-null, not mapped
+//		param path: path of file
+//			valid: non-null, non-empty
+//		param size: bytes in file
+//			valid: non-zero
+//		return SUCCESS: ijk_success if file created and mapped
+//		return FAILURE: ijk_fail_specified if file not created or mapped
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMapCreate(ijkMap* const map, kstr const path, size_t const size);
+
+// ijkMapOpen
+//	Map existing file whole.
+//		param map: pointer to descriptor that stores map info
+//			valid: non-null, not mapped
+//		param path: path of file
+//			valid: non-null, non-empty
+//		param writable: map for writing as well as reading
+//		return SUCCESS: ijk_success if file mapped
+//		return FAILURE: ijk_fail_specified if file not opened (or empty) or mapped
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMapOpen(ijkMap* const map, kstr const path, bool const writable);
+
+// ijkMapRelease
+//	Unmap file and close it; writes reach the file.
+//		param map: pointer to descriptor that stores map info
+//			valid: non-null, mapped
+//		return SUCCESS: ijk_success if file unmapped
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMapRelease(ijkMap* const map);
+
+// ijkMapFind
+//	Call function for each file in directory whose name starts with prefix.
+//		param directory: path of directory
+//			valid: non-null, non-empty
+//		param prefix: start of file names
+//			valid: non-null
+//		param func: function called per file
+//			valid: non-null
+//		param args: pointer passed to function
+//		return SUCCESS: ijk_success if directory searched (files or not)
+//		return FAILURE: ijk_fail_specified if directory could not be searched
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMapFind(kstr const directory, kstr const prefix, ijkMapFindFunc const func, ptr const args);
+
+// ijkMapGetSharedDirectory
+//	Get directory for files shared between processes: the temporary 
+//		directory ("TEMP"), or the working directory if it is not set; 
+//		files there are created temporary, so they stay in cache.
+//		return: path of directory
+kstr ijkMapGetSharedDirectory();
+
+// ijkMapGetProcessId
+//	Get identifier of calling process.
+//		return: process identifier
+ui32 ijkMapGetProcessId();
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_MAP_H_
\ No newline at end of file
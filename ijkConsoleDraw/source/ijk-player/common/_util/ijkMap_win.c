@@ -0,0 +1,152 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkMap_win.c
+	Memory-mapped file source for Windows.
+*/
+
+#include "ijkMap.h"
+#if ijk_platform_is(WINDOWS)
+
+#include <Windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Map opened file into memory, closing it on failure
+static iret ijkMapInternalView(ijkMap* const map, HANDLE const file, size_t const size, bool const writable)
+{
+	HANDLE const mapping = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+		(DWORD)((ui64)size >> 32), (DWORD)size, NULL);
+	ptr const data = mapping ? MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size) : NULL;
+	if (!data)
+	{
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return ijk_failcodespec(ijk_fail_map_view);
+	}
+	map->handle[0] = file;
+	map->handle[1] = mapping;
+	map->data = (byte*)data;
+	map->size = size;
+	map->writable = writable;
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkMapCreate(ijkMap* const map, kstr const path, size_t const size)
+{
+	ijk_assertparamptr(map);
+	ijk_assertparamstr(path);
+	ijk_assertparam(size && !map->data);
+
+	// other processes may read and write while this one has it mapped
+	HANDLE const file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return ijk_failcodespec(ijk_fail_map_open);
+	return ijkMapInternalView(map, file, size, true);
+}
+
+
+iret ijkMapOpen(ijkMap* const map, kstr const path, bool const writable)
+{
+	LARGE_INTEGER size;
+	ijk_assertparamptr(map);
+	ijk_assertparamstr(path);
+	ijk_assertparam(!map->data);
+
+	HANDLE const file = CreateFileA(path, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return ijk_failcodespec(ijk_fail_map_open);
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || (ui64)size.QuadPart > (ui64)(size_t)-1)
+	{
+		CloseHandle(file);
+		return ijk_failcodespec(ijk_fail_map_open);
+	}
+	return ijkMapInternalView(map, file, (size_t)size.QuadPart, writable);
+}
+
+
+iret ijkMapRelease(ijkMap* const map)
+{
+	ijk_assertparamptr(map);
+	ijk_assertparamptr(map->data);
+
+	UnmapViewOfFile(map->data);
+	CloseHandle(map->handle[1]);
+	CloseHandle(map->handle[0]);
+	map->handle[0] = map->handle[1] = 0;
+	map->data = 0;
+	map->size = 0;
+	return ijk_success;
+}
+
+
+iret ijkMapFind(kstr const directory, kstr const prefix, ijkMapFindFunc const func, ptr const args)
+{
+	WIN32_FIND_DATAA found[1];
+	char path[MAX_PATH];
+	ijk_assertparamstr(directory);
+	ijk_assertparamptr(prefix);
+	ijk_assertparamptr(func);
+
+	sprintf(path, "%.200s\\%.50s*", directory, prefix);
+	HANDLE const search = FindFirstFileA(path, found);
+	if (search == INVALID_HANDLE_VALUE)
+		return (GetLastError() == ERROR_FILE_NOT_FOUND ? ijk_success : ijk_failcodespec(ijk_fail_map_find));
+	do
+	{
+		if (found->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			continue;
+		sprintf(path, "%.200s\\%.50s", directory, found->cFileName);
+		if (!func(path, args))
+			break;
+	} while (FindNextFileA(search, found));
+	FindClose(search);
+	return ijk_success;
+}
+
+
+kstr ijkMapGetSharedDirectory()
+{
+	// no memory-backed file system: temporary files stay in cache
+	kstr const temp = getenv("TEMP");
+	return (temp && *temp ? temp : ".");
+}
+
+
+ui32 ijkMapGetProcessId()
+{
+	return (ui32)GetCurrentProcessId();
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkMetrics.c
+	Shared-memory metrics source.
+*/
+
+#include "ijkMetrics.h"
+#include "ijkThread.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Reads attempted before writer is considered stuck
+#define ijkMetricsReadTries			4096
+
+// Instances found in directory
+typedef struct
+{
+	ui32 count;
+	ui32 pid[ijkMetricsInstanceMax];
+	char name[ijkMetricsInstanceMax][32];
+	ijkMetricsData data[ijkMetricsInstanceMax];
+} ijkMetricsFound;
+
+// Prometheus metric written per instance
+typedef struct
+{
+	kstr name, type, help;
+	f64(*value)(ijkMetricsData const* data);
+} ijkMetricsFamily;
+
+static f64 ijkMetricsFrameTime(ijkMetricsData const* data) { return data->frameMs * 0.001; }
+static f64 ijkMetricsFPS(ijkMetricsData const* data) { return data->fps; }
+static f64 ijkMetricsRays(ijkMetricsData const* data) { return data->raysPerSec; }
+static f64 ijkMetricsBytes(ijkMetricsData const* data) { return data->bytesPerFrame; }
+static f64 ijkMetricsFrames(ijkMetricsData const* data) { return (f64)data->frames; }
+static f64 ijkMetricsUpdated(ijkMetricsData const* data) { return (f64)data->updated; }
+
+static ijkMetricsFamily const ijkMetricsFamilies[] = {
+	{ "ijk_frame_time_seconds", "gauge", "Time of last frame.", ijkMetricsFrameTime },
+	{ "ijk_frames_per_second", "gauge", "Frames per second.", ijkMetricsFPS },
+	{ "ijk_rays_per_second", "gauge", "Rays traced per second.", ijkMetricsRays },
+	{ "ijk_bytes_per_frame", "gauge", "Bytes of output for last frame.", ijkMetricsBytes },
+	{ "ijk_frames_total", "counter", "Frames published.", ijkMetricsFrames },
+	{ "ijk_last_update_timestamp_seconds", "gauge", "Time of last publish; stale if the instance stopped without removing its file.", ijkMetricsUpdated },
+};
+
+// Keep instance found in directory
+static bool ijkMetricsFind(kstr const path, ptr const args)
+{
+	ijkMetricsFound* const found = (ijkMetricsFound*)args;
+	ijkMap map = { 0 };
+	ijkMetrics const* metrics;
+	if (ijk_issuccess(ijkMapOpen(&map, path, false)))
+	{
+		metrics = (ijkMetrics const*)map.data;
+		if (ijk_issuccess(ijkMetricsRead(metrics, map.size, found->data + found->count)))
+		{
+			found->pid[found->count] = metrics->pid;
+			memcpy(found->name[found->count], metrics->name, sizeof(metrics->name));
+			found->name[found->count][sizeof(metrics->name) - 1] = 0;
+			++found->count;
+		}
+		ijkMapRelease(&map);
+	}
+	return (found->count < ijkMetricsInstanceMax);
+}
+
+// Write label value, escaped
+static void ijkMetricsWriteLabel(FILE* const stream, kstr value)
+{
+	for (; *value; ++value)
+	{
+		if (*value == '\\' || *value == '"')
+			fputc('\\', stream);
+		if (*value == '\n')
+			fputs("\\n", stream);
+		else
+			fputc(*value, stream);
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkMetricsCreate(ijkMetricsFile* const file, kstr const directory, kstr const name)
+{
+	iret status;
+	ijkMetrics* metrics;
+	ui32 const pid = ijkMapGetProcessId();
+	ijk_assertparamptr(file);
+	ijk_assertparamstr(directory);
+	ijk_assertparamptr(name);
+	ijk_assertparamnull(file->metrics);
+
+	sprintf(file->path, "%.200s/" ijkMetricsPrefix "%u", directory, pid);
+	status = ijkMapCreate(&file->map, file->path, sizeof(ijkMetrics));
+	if (!ijk_issuccess(status))
+		return status;
+
+	// readers skip the file until the tag is stored
+	metrics = (ijkMetrics*)file->map.data;
+	metrics->version = ijkMetricsVersion;
+	metrics->size = sizeof(ijkMetrics);
+	metrics->pid = pid;
+	strncpy(metrics->name, name, sizeof(metrics->name) - 1);
+	ijkThreadAtomicStore((i32 volatile*)&metrics->magic, (i32)ijkMetricsMagic);
+	file->metrics = metrics;
+	return ijk_success;
+}
+
+
+iret ijkMetricsRelease(ijkMetricsFile* const file)
+{
+	ijk_assertparamptr(file);
+	ijk_assertparamptr(file->metrics);
+
+	ijkMapRelease(&file->map);
+	remove(file->path);
+	file->metrics = 0;
+	return ijk_success;
+}
+
+
+iret ijkMetricsPublish(ijkMetrics* const metrics, ijkMetricsData const* const data)
+{
+	i32 const sequence = metrics ? metrics->sequence : 0;
+	ijk_assertparamptr(metrics);
+	ijk_assertparamptr(data);
+
+	// odd sequence tells readers to retry; the stores are full barriers,
+	//	so values land strictly between them
+	ijkThreadAtomicStore(&metrics->sequence, sequence + 1);
+	metrics->data.frameMs = data->frameMs;
+	metrics->data.fps = data->fps;
+	metrics->data.raysPerSec = data->raysPerSec;
+	metrics->data.bytesPerFrame = data->bytesPerFrame;
+	metrics->data.frames = metrics->data.frames + 1;
+	metrics->data.updated = (i64)time(0);
+	ijkThreadAtomicStore(&metrics->sequence, sequence + 2);
+	return ijk_success;
+}
+
+
+iret ijkMetricsRead(ijkMetrics const* const metrics, size_t const size, ijkMetricsData* const data_out)
+{
+	i32 sequence, tries;
+	i32 volatile const* const shared = metrics ? &metrics->sequence : 0;
+	ijk_assertparamptr(metrics);
+	ijk_assertparamptr(data_out);
+
+	if (size < sizeof(ijkMetrics)
+		|| ijkThreadAtomicLoad((i32 volatile const*)&metrics->magic) != (i32)ijkMetricsMagic
+		|| metrics->version != ijkMetricsVersion || metrics->size != sizeof(ijkMetrics))
+		return ijk_failcodespec(ijk_fail_metrics_format);
+
+	// copy is only kept if no publish started or finished during it
+	for (tries = 0; tries < ijkMetricsReadTries; ++tries)
+	{
+		sequence = ijkThreadAtomicLoad(shared);
+		if (!(sequence & 1))
+		{
+			*data_out = metrics->data;
+			if (ijkThreadAtomicLoad(shared) == sequence)
+				return ijk_success;
+		}
+		ijkThreadYield();
+	}
+	return ijk_failcodespec(ijk_fail_metrics_busy);
+}
+
+
+iret ijkMetricsWrite(FILE* const stream, kstr const directory, ui32* const count_out_opt)
+{
+	ijkMetricsFound* found;
+	ijkMetricsFamily const* family;
+	iret status;
+	ui32 i;
+	ijk_assertparamptr(stream);
+	ijk_assertparamstr(directory);
+
+	found = (ijkMetricsFound*)calloc(1, sizeof(*found));
+	if (!found)
+		return ijk_failcode(ijk_fail_allocation);
+	status = ijkMapFind(directory, ijkMetricsPrefix, ijkMetricsFind, found);
+	if (!ijk_issuccess(status))
+	{
+		free(found);
+		return status;
+	}
+
+	// samples of one metric must be grouped under its description
+	for (family = ijkMetricsFamilies; found->count && family < ijkMetricsFamilies + sizeof(ijkMetricsFamilies) / sizeof(*ijkMetricsFamilies); ++family)
+	{
+		fprintf(stream, "# HELP %s %s\n# TYPE %s %s\n", family->name, family->help, family->name, family->type);
+		for (i = 0; i < found->count; ++i)
+		{
+			fprintf(stream, "%s{pid=\"%u\",mode=\"", family->name, found->pid[i]);
+			ijkMetricsWriteLabel(stream, found->name[i]);
+			fprintf(stream, "\"} %.15g\n", family->value(found->data + i));
+		}
+	}
+	if (count_out_opt)
+		*count_out_opt = found->count;
+	free(found);
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkMetrics.h
+	Shared-memory metrics interface: each instance publishes a versioned
+		block in its own memory-mapped file; a sequence number that is odd
+		while the block is written lets readers in other processes copy it
+		without blocking the writer (sequence lock).
+*/
+
+#ifndef _IJK_METRICS_H_
+#define _IJK_METRICS_H_
+
+#include "ijkMap.h"
+
+#include <stdio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkMetrics)
+{
+	ijk_fail_metrics_format,	// Failure with metrics layout (magic, version or size).
+	ijk_fail_metrics_busy,		// Failure with metrics read (writer never idle).
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkMetricsMagic
+//	Tag at start of metrics file ("ijKM" in memory).
+#define ijkMetricsMagic				0x4d4b6a69
+
+// ijkMetricsVersion
+//	Layout version; readers skip other versions.
+#define ijkMetricsVersion			1
+
+// ijkMetricsPrefix
+//	Start of metrics file names; process identifier follows.
+#define ijkMetricsPrefix			"ijk-metrics-"
+
+// ijkMetricsInstanceMax
+//	Most instances written per dump.
+#define ijkMetricsInstanceMax		64
+
+// ijkMetricsData
+//	Values published per frame.
+IJK_DECL_STRUCT(ijkMetricsData)
+{
+	f64 frameMs;				// Time of last frame in milliseconds.
+	f64 fps;					// Frames per second.
+	f64 raysPerSec;				// Rays traced per second.
+	f64 bytesPerFrame;			// Bytes of output for last frame.
+	ui64 frames;				// Frames published (kept by publisher).
+	i64 updated;				// Seconds since epoch at last publish (kept by publisher).
+};
+
+// ijkMetrics
+//	Layout of metrics file.
+IJK_DECL_STRUCT(ijkMetrics)
+{
+	ui32 magic;					// Tag, stored last when created.
+	ui32 version;				// Layout version.
+	ui32 size;					// Bytes of layout.
+	ui32 pid;					// Process identifier of publisher.
+	i32 volatile sequence;		// Publish count times two; odd while writing.
+	ui32 reserved;				// Alignment of data.
+	char name[32];				// Instance name (mode).
+	ijkMetricsData data;		// Last values published.
+};
+
+// ijkMetricsFile
+//	Descriptor for metrics published by this process.
+IJK_DECL_STRUCT(ijkMetricsFile)
+{
+	ijkMap map;					// Mapped file.
+	ijkMetrics* metrics;		// Layout in mapped file; null if not created.
+	char path[256];				// Path of file, removed on release.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkMetricsCreate
+//	Create metrics file for this process in directory.
+//		param file: pointer to descriptor that stores metrics file
+//			valid: non-null, not created
+//		param directory: directory of metrics files
+//			valid: non-null, non-empty
+//		param name: instance name
+//			valid: non-null
+//		return SUCCESS: ijk_success if file created
+//		return FAILURE: ijk_fail_specified if file not created (see ijkMap)
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMetricsCreate(ijkMetricsFile* const file, kstr const directory, kstr const name);
+
+// ijkMetricsRelease
+//	Unmap and remove metrics file.
+//		param file: pointer to descriptor that stores metrics file
+//			valid: non-null, created
+//		return SUCCESS: ijk_success if file released
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMetricsRelease(ijkMetricsFile* const file);
+
+// ijkMetricsPublish
+//	Copy values into metrics without locking; one writer per metrics.
+//		param metrics: pointer to layout in metrics file
+//			valid: non-null
+//		param data: pointer to values published (frames and time ignored)
+//			valid: non-null
+//		return SUCCESS: ijk_success if values published
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMetricsPublish(ijkMetrics* const metrics, ijkMetricsData const* const data);
+
+// ijkMetricsRead
+//	Copy consistent values out of metrics, retrying while written.
+//		param metrics: pointer to layout in metrics file
+//			valid: non-null
+//		param size: bytes mapped at metrics
+//		param data_out: pointer to values copied
+//			valid: non-null
+//		return SUCCESS: ijk_success if values copied
+//		return FAILURE: ijk_fail_specified if layout unknown or writer busy
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMetricsRead(ijkMetrics const* const metrics, size_t const size, ijkMetricsData* const data_out);
+
+// ijkMetricsWrite
+//	Write metrics of every instance in directory, in Prometheus text format.
+//		param stream: output stream
+//			valid: non-null
+//		param directory: directory of metrics files
+//			valid: non-null, non-empty
+//		param count_out_opt: optional pointer to number of instances written
+//		return SUCCESS: ijk_success if directory searched (instances or not)
+//		return FAILURE: ijk_fail_specified if directory could not be searched
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkMetricsWrite(FILE* const stream, kstr const directory, ui32* const count_out_opt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_METRICS_H_
\ No newline at end of file
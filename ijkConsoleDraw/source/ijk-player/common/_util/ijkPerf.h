@@ -0,0 +1,114 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkPerf.h
+	Hardware performance counter interface.
+	The Windows source only counts cycles charged to the thread; other 
+		counters stay unavailable and are reported as such.
+*/
+
+#ifndef _IJK_PERF_H_
+#define _IJK_PERF_H_
+
+#include "ijk/ijk/ijk-typedefs.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkPerf)
+{
+	ijk_fail_perf_open,		// Failure with perf open (unsupported or forbidden).
+	ijk_fail_perf_read,		// Failure with perf read.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkPerfCounter
+//	List of hardware events counted.
+IJK_DECL_ENUM(ijkPerfCounter)
+{
+	ijkPerfCounter_cycles,			// Processor cycles.
+	ijkPerfCounter_instructions,	// Instructions retired.
+	ijkPerfCounter_missL1d,			// Level 1 data cache read misses.
+	ijkPerfCounter_missLlc,			// Last level cache read misses.
+	ijkPerfCounter_missBranch,		// Mispredicted branches.
+
+	ijkPerfCounter_count			// Number of counters.
+};
+
+// ijkPerf
+//	Descriptor for hardware counters of one thread, counted as a group.
+IJK_DECL_STRUCT(ijkPerf)
+{
+	i32 handle[ijkPerfCounter_count];	// Platform handle per counter; negative if not open.
+	ui32 slot[ijkPerfCounter_count];	// Position of counter in group.
+	bool available[ijkPerfCounter_count];	// Counter is open.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkPerfOpen
+//	Open and start counters for calling thread; counters the platform 
+//		does not provide are left unavailable.
+//		param perf: pointer to descriptor that stores counter info
+//			valid: non-null
+//		return SUCCESS: ijk_success if any counter opened
+//		return FAILURE: ijk_fail_specified if no counter opened
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPerfOpen(ijkPerf* const perf);
+
+// ijkPerfRead
+//	Read counts since open; counts are scaled up if the group was
+//		multiplexed with other counters.
+//		param perf: pointer to descriptor that stores counter info
+//			valid: non-null, open, same thread as open
+//		param count_out: count per counter; zero if unavailable
+//			valid: non-null
+//		return SUCCESS: ijk_success if counters read
+//		return FAILURE: ijk_fail_specified if counters could not be read
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPerfRead(ijkPerf const* const perf, ui64 count_out[ijkPerfCounter_count]);
+
+// ijkPerfClose
+//	Stop and close counters.
+//		param perf: pointer to descriptor that stores counter info
+//			valid: non-null
+//		return SUCCESS: ijk_success if counters closed
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPerfClose(ijkPerf* const perf);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_PERF_H_
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkPerf_win.c
+	Hardware performance counter source for Windows.
+	Event counters are not available to user mode without a driver; the 
+		only count is processor cycles charged to the thread (user and 
+		kernel mode), read from the scheduler with QueryThreadCycleTime.
+*/
+
+#include "ijkPerf.h"
+#if ijk_platform_is(WINDOWS)
+
+#include <Windows.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkPerfOpen(ijkPerf* const perf)
+{
+	ijkPerfCounter counter;
+	ULONG64 cycles;
+	ijk_assertparamptr(perf);
+
+	for (counter = ijkPerfCounter_cycles; counter < ijkPerfCounter_count; ++counter)
+	{
+		perf->handle[counter] = -1;
+		perf->slot[counter] = 0;
+		perf->available[counter] = false;
+	}
+	if (!QueryThreadCycleTime(GetCurrentThread(), &cycles))
+		return ijk_failcodespec(ijk_fail_perf_open);
+
+	// cycles are read from the calling thread, so no handle is kept
+	perf->handle[ijkPerfCounter_cycles] = 0;
+	perf->available[ijkPerfCounter_cycles] = true;
+	return ijk_success;
+}
+
+
+iret ijkPerfRead(ijkPerf const* const perf, ui64 count_out[ijkPerfCounter_count])
+{
+	ULONG64 cycles;
+	ijk_assertparamptr(perf);
+	ijk_assertparamptr(count_out);
+
+	memset(count_out, 0, sizeof(*count_out) * ijkPerfCounter_count);
+	if (!perf->available[ijkPerfCounter_cycles] || !QueryThreadCycleTime(GetCurrentThread(), &cycles))
+		return ijk_failcodespec(ijk_fail_perf_read);
+	count_out[ijkPerfCounter_cycles] = (ui64)cycles;
+	return ijk_success;
+}
+
+
+iret ijkPerfClose(ijkPerf* const perf)
+{
+	ijkPerfCounter counter;
+	ijk_assertparamptr(perf);
+
+	for (counter = ijkPerfCounter_cycles; counter < ijkPerfCounter_count; ++counter)
+	{
+		perf->handle[counter] = -1;
+		perf->available[counter] = false;
+	}
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
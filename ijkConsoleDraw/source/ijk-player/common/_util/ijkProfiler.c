@@ -0,0 +1,199 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkProfiler.c
+	Scoped-zone profiler source.
+*/
+
+#include "ijkProfiler.h"
+#include "ijkTimer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+ijk_threadlocal ijkProfilerThread* ijkProfilerLocal;
+
+// Recording shared by all threads
+//	-> ticks are processor cycles where there is a counter, nanoseconds
+//		from the timer otherwise; cycles are converted when written,
+//		against the timer started with recording
+static struct
+{
+	ijkTimer timer[1];			// Timer started with recording
+	ui64 tickStart;				// Tick when recording started
+	bool cycles;				// Ticks are processor cycles
+	i32 volatile recording;		// Non-zero while recording
+	i32 volatile threads;		// Rings claimed (may pass maximum)
+	ijkProfilerThread* thread[ijkProfilerThreadMax];	// Ring per thread
+} profiler;
+
+// Get tick for zone
+static ui64 ijkProfilerTick()
+{
+	return (profiler.cycles ? ijkTimerCycles() : (ui64)(ijkTimerElapsed(profiler.timer) * 1.0e9));
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkProfilerStart()
+{
+	iret status;
+	ijkProfilerStop();
+	status = ijkTimerInit(profiler.timer);
+	if (!ijk_issuccess(status))
+		return status;
+
+	profiler.cycles = ijkTimerCycles() != 0;
+	profiler.tickStart = ijkProfilerTick();
+	ijkThreadAtomicStore(&profiler.recording, 1);
+	return ijk_success;
+}
+
+
+void ijkProfilerStop()
+{
+	i32 i;
+	i32 const threads = ijk_minimum(profiler.threads, ijkProfilerThreadMax);
+	ijkThreadAtomicStore(&profiler.recording, 0);
+	for (i = 0; i < threads; ++i)
+	{
+		free(profiler.thread[i]);
+		profiler.thread[i] = 0;
+	}
+	ijkThreadAtomicStore(&profiler.threads, 0);
+}
+
+
+iret ijkProfilerThreadBegin(kstr const name)
+{
+	ijkProfilerThread* thread;
+	i32 index;
+	ijk_assertparamptr(name);
+
+	if (!ijkThreadAtomicLoad(&profiler.recording))
+		return ijk_failcodespec(ijk_fail_profiler_stopped);
+	if (ijkProfilerLocal)
+		return ijk_success;
+	index = ijkThreadAtomicIncrement(&profiler.threads) - 1;
+	if (index >= ijkProfilerThreadMax)
+		return ijk_failcodespec(ijk_fail_profiler_thread);
+	thread = (ijkProfilerThread*)calloc(1, sizeof(*thread));
+	if (!thread)
+		return ijk_failcode(ijk_fail_allocation);
+
+	strncpy(thread->name, name, sizeof(thread->name) - 1);
+	thread->id = (ui32)index + 1;
+	profiler.thread[index] = thread;
+	ijkProfilerLocal = thread;
+	return ijk_success;
+}
+
+
+void ijkProfilerThreadEnd()
+{
+	ijkProfilerLocal = 0;
+}
+
+
+iret ijkProfilerWrite(kstr const path)
+{
+	ijkProfilerThread const* thread;
+	ijkProfilerZone const* zone;
+	FILE* file;
+	ui32 i, n, dropped = 0;
+	i32 t;
+	bool written;
+	ijk_assertparamptr(path);
+
+	if (!ijkThreadAtomicLoad(&profiler.recording))
+		return ijk_failcodespec(ijk_fail_profiler_stopped);
+	file = fopen(path, "w");
+	if (!file)
+		return ijk_failcodespec(ijk_fail_profiler_write);
+
+	// trace event format: one complete event per zone, times in microseconds
+	f64 const seconds = ijkTimerElapsed(profiler.timer);
+	ui64 const ticks = ijkProfilerTick() - profiler.tickStart;
+	f64 const usPerTick = !profiler.cycles ? 1.0e-3 : ticks ? seconds * 1.0e6 / (f64)ticks : 0.0;
+	i32 const threads = ijk_minimum(ijkThreadAtomicLoad(&profiler.threads), ijkProfilerThreadMax);
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"ijk-player\"}}");
+	for (t = 0; t < threads; ++t)
+	{
+		thread = profiler.thread[t];
+		if (!thread)
+			continue;
+		fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", thread->id, thread->name);
+
+		// oldest zone still in ring first
+		n = ijk_minimum(thread->count, ijkProfilerZoneCapacity);
+		dropped += thread->count - n;
+		for (i = thread->count - n; i != thread->count; ++i)
+		{
+			zone = thread->zone + (i & (ijkProfilerZoneCapacity - 1));
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", zone->name, thread->id,
+				(f64)(zone->begin - profiler.tickStart) * usPerTick, (f64)(zone->end - zone->begin) * usPerTick);
+		}
+	}
+	fprintf(file, "\n],\"otherData\":{\"zones_dropped\":%u}}\n", dropped);
+	written = !ferror(file);
+	written = !fclose(file) && written;
+	return (written ? ijk_success : ijk_failcodespec(ijk_fail_profiler_write));
+}
+
+
+//-----------------------------------------------------------------------------
+
+void ijkProfilerZoneBegin(kstr const name)
+{
+	ijkProfilerThread* const thread = ijkProfilerLocal;
+	if (!thread)
+		return;
+	if (thread->depth < ijkProfilerDepthMax)
+	{
+		thread->openName[thread->depth] = name;
+		thread->openBegin[thread->depth] = ijkProfilerTick();
+	}
+	++thread->depth;
+}
+
+
+void ijkProfilerZoneEnd()
+{
+	ijkProfilerThread* const thread = ijkProfilerLocal;
+	ui64 const tick = thread ? ijkProfilerTick() : 0;
+	if (!thread || !thread->depth)
+		return;
+	if (--thread->depth < ijkProfilerDepthMax)
+	{
+		ijkProfilerZone* const zone = thread->zone + (thread->count++ & (ijkProfilerZoneCapacity - 1));
+		zone->name = thread->openName[thread->depth];
+		zone->begin = thread->openBegin[thread->depth];
+		zone->end = tick;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkProfiler.h
+	Scoped-zone profiler interface: per-thread rings of timed zones,
+		written out as a trace for chrome://tracing or Perfetto.
+*/
+
+#ifndef _IJK_PROFILER_H_
+#define _IJK_PROFILER_H_
+
+#include "ijkThread.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// IJK_PROFILER
+//	If defined, zone macros record; comment out to compile them out.
+#define IJK_PROFILER
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkProfiler)
+{
+	ijk_fail_profiler_stopped,	// Failure with profiler not recording.
+	ijk_fail_profiler_thread,	// Failure with profiler thread (no ring left).
+	ijk_fail_profiler_write,	// Failure with profiler trace write.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkProfilerZoneCapacity
+//	Zones kept per thread (power of two); older zones are overwritten.
+#define ijkProfilerZoneCapacity		8192
+
+// ijkProfilerDepthMax
+//	Zones open at once per thread; deeper zones are not recorded.
+#define ijkProfilerDepthMax			16
+
+// ijkProfilerThreadMax
+//	Threads recorded between start and stop.
+#define ijkProfilerThreadMax		64
+
+// ijkProfilerZone
+//	Descriptor for closed zone.
+IJK_DECL_STRUCT(ijkProfilerZone)
+{
+	kstr name;					// Name of zone; must outlive recording.
+	ui64 begin, end;			// Ticks when zone opened and closed.
+};
+
+// ijkProfilerThread
+//	Descriptor for thread's ring of zones.
+IJK_DECL_STRUCT(ijkProfilerThread)
+{
+	char name[32];				// Name of thread in trace.
+	ui32 id;					// Thread number in trace.
+	ui32 count;					// Zones closed since start (ring keeps the last).
+	ui32 depth;					// Zones open now.
+	kstr openName[ijkProfilerDepthMax];	// Names of zones open now.
+	ui64 openBegin[ijkProfilerDepthMax];	// Ticks when zones open now opened.
+	ijkProfilerZone zone[ijkProfilerZoneCapacity];	// Ring of closed zones.
+};
+
+// ijkProfilerLocal
+//	Calling thread's ring; null unless thread is recording.
+extern ijk_threadlocal ijkProfilerThread* ijkProfilerLocal;
+
+
+//-----------------------------------------------------------------------------
+
+// ijk_zone_begin
+//	Open zone on calling thread; does nothing unless thread is recording.
+//		param name: name of zone (string literal or other static string)
+// ijk_zone_end
+//	Close zone most recently opened on calling thread.
+#ifdef IJK_PROFILER
+#define ijk_zone_begin(name)		(ijkProfilerLocal ? ijkProfilerZoneBegin(name) : (void)0)
+#define ijk_zone_end()				(ijkProfilerLocal ? ijkProfilerZoneEnd() : (void)0)
+#else	// !IJK_PROFILER
+#define ijk_zone_begin(name)		((void)0)
+#define ijk_zone_end()				((void)0)
+#endif	// IJK_PROFILER
+
+
+//-----------------------------------------------------------------------------
+
+// ijkProfilerStart
+//	Discard previous recording and start new one; threads record once
+//		they begin (see below).
+//		return SUCCESS: ijk_success if recording started
+//		return FAILURE: ijk_fail_specified if timer unavailable
+iret ijkProfilerStart();
+
+// ijkProfilerStop
+//	Stop recording and release every thread's ring; every thread that
+//		began must have ended first.
+void ijkProfilerStop();
+
+// ijkProfilerThreadBegin
+//	Give calling thread a ring so its zones record.
+//		param name: name of thread in trace
+//			valid: non-null
+//		return SUCCESS: ijk_success if thread is recording
+//		return FAILURE: ijk_fail_specified if not started or no ring left
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkProfilerThreadBegin(kstr const name);
+
+// ijkProfilerThreadEnd
+//	Stop recording on calling thread; its zones are kept until stop.
+void ijkProfilerThreadEnd();
+
+// ijkProfilerWrite
+//	Write zones recorded so far as trace event JSON; zones still open are
+//		left out, and threads still recording elsewhere should have ended.
+//		param path: path of trace file
+//			valid: non-null
+//		return SUCCESS: ijk_success if trace written
+//		return FAILURE: ijk_fail_specified if not started or file not written
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkProfilerWrite(kstr const path);
+
+// ijkProfilerZoneBegin
+//	Open zone on calling thread (use ijk_zone_begin).
+//		param name: name of zone
+void ijkProfilerZoneBegin(kstr const name);
+
+// ijkProfilerZoneEnd
+//	Close zone on calling thread (use ijk_zone_end).
+void ijkProfilerZoneEnd();
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_PROFILER_H_
\ No newline at end of file
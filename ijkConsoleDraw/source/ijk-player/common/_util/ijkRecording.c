@@ -0,0 +1,365 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkRecording.c
+	Frame recording source.
+*/
+
+#include "ijkRecording.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Cells per frame
+#define ijkRecordingCells(header)	((ui32)(header)->width * (ui32)(header)->height)
+
+// Most bytes of runs per frame: one run per cell, two counts of at most
+//	five bytes and a color each
+#define ijkRecordingCapacity(cells)	((size_t)(cells) * 11)
+
+// Write count as variable-length integer
+static byte* ijkRecordingPutCount(byte* out, ui32 count)
+{
+	while (count >= 0x80)
+	{
+		*out++ = (byte)(count | 0x80);
+		count >>= 7;
+	}
+	*out++ = (byte)count;
+	return out;
+}
+
+// Read count as variable-length integer; null if it runs past end
+static byte const* ijkRecordingGetCount(byte const* in, byte const* const end, ui32* const count_out)
+{
+	ui32 count = 0, shift;
+	for (shift = 0; in < end && shift < 32; shift += 7)
+	{
+		count |= (ui32)(*in & 0x7f) << shift;
+		if (!(*in++ & 0x80))
+		{
+			*count_out = count;
+			return in;
+		}
+	}
+	return 0;
+}
+
+// Encode cells as runs against previous cells (keyframe if none)
+//	-> a run is the cells left unchanged before it, then cells of one
+//		color; a run continues over cells that happen to be unchanged,
+//		and unchanged cells at the end need no run
+static size_t ijkRecordingEncode(byte* const buffer, byte const* const cells, byte const* const cells_prev, ui32 const count)
+{
+	byte* out = buffer;
+	ui32 i = 0, start;
+	byte color;
+	while (i < count)
+	{
+		start = i;
+		if (cells_prev)
+			while (i < count && cells[i] == cells_prev[i])
+				++i;
+		if (i == count)
+			break;
+		out = ijkRecordingPutCount(out, i - start);
+		color = cells[i];
+		for (start = i; i < count && cells[i] == color; ++i);
+		out = ijkRecordingPutCount(out, i - start);
+		*out++ = color;
+	}
+	return (size_t)(out - buffer);
+}
+
+// Apply runs to cells
+static bool ijkRecordingDecode(byte* const cells, ui32 const count, byte const* in, byte const* const end)
+{
+	ui32 i = 0, skip, length;
+	while (in < end)
+	{
+		in = ijkRecordingGetCount(in, end, &skip);
+		in = in ? ijkRecordingGetCount(in, end, &length) : 0;
+		if (!in || in >= end || skip > count - i || length > count - i - skip)
+			return false;
+		i += skip;
+		memset(cells + i, *in++, length);
+		i += length;
+	}
+	return true;
+}
+
+// Write frame at front of queue to file, keeping index of keyframes
+static void ijkRecorderWrite(ijkRecorder* const recorder, i32 const written)
+{
+	ui32 const count = ijkRecordingCells(&recorder->header);
+	ui32 const slot = (ui32)written % ijkRecordingQueue;
+	byte const* const cells = recorder->queue + (size_t)slot * count;
+	ijkRecordingFrame record = { recorder->queueFrame[slot] };
+	ijkRecordingIndex* index;
+
+	record.key = (recorder->header.frames % recorder->header.keyInterval) == 0;
+	if (record.key)
+	{
+		if (recorder->header.keyframes == recorder->indexCapacity)
+		{
+			index = (ijkRecordingIndex*)realloc(recorder->index, (size_t)(recorder->indexCapacity * 2 + 16) * sizeof(*index));
+			if (!index)
+			{
+				recorder->failed = true;
+				return;
+			}
+			recorder->index = index;
+			recorder->indexCapacity = recorder->indexCapacity * 2 + 16;
+		}
+		index = recorder->index + recorder->header.keyframes++;
+		index->record = recorder->header.frames;
+		index->frame = record.frame;
+		index->offset = recorder->offset;
+	}
+	record.size = (ui32)ijkRecordingEncode(recorder->buffer, cells, record.key ? 0 : recorder->prev, count);
+	if (fwrite(&record, sizeof(record), 1, recorder->file) != 1 || fwrite(recorder->buffer, 1, record.size, recorder->file) != record.size)
+		recorder->failed = true;
+	memcpy(recorder->prev, cells, count);
+	recorder->offset += sizeof(record) + record.size;
+	recorder->bytes += record.size;
+	++recorder->header.frames;
+}
+
+// Recording thread: write queued frames in order until closed
+static iret ijkRecorderRun(ptr const args)
+{
+	ijkRecorder* const recorder = (ijkRecorder*)args;
+	i32 written = 0, queued;
+	bool closing;
+	for (;;)
+	{
+		// closing is read first, so frames queued before it are written
+		closing = ijkThreadAtomicLoad(&recorder->closing) != 0;
+		queued = ijkThreadAtomicLoad(&recorder->queued);
+		if (written == queued)
+		{
+			if (closing)
+				break;
+			ijkThreadSleep(1);
+			continue;
+		}
+		for (; written != queued; ++written)
+		{
+			if (!recorder->failed)
+				ijkRecorderWrite(recorder, written);
+			ijkThreadAtomicStore(&recorder->written, written + 1);
+		}
+	}
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkRecorderOpen(ijkRecorder* const recorder, kstr const path, ui16 const width, ui16 const height, ui32 const keyInterval)
+{
+	ijkRecorder const reset = { 0 };
+	ui32 const count = (ui32)width * (ui32)height;
+	ijk_assertparamptr(recorder);
+	ijk_assertparamstr(path);
+	ijk_assertparam(count && keyInterval);
+	ijk_assertparamnull(recorder->file);
+
+	*recorder = reset;
+	recorder->header.magic = ijkRecordingMagic;
+	recorder->header.version = ijkRecordingVersion;
+	recorder->header.width = width;
+	recorder->header.height = height;
+	recorder->header.keyInterval = keyInterval;
+	recorder->queue = (byte*)malloc((size_t)count * ijkRecordingQueue);
+	recorder->prev = (byte*)malloc(count);
+	recorder->buffer = (byte*)malloc(ijkRecordingCapacity(count));
+	if (!recorder->queue || !recorder->prev || !recorder->buffer)
+	{
+		free(recorder->queue);
+		free(recorder->prev);
+		free(recorder->buffer);
+		return ijk_failcode(ijk_fail_allocation);
+	}
+
+	// header is written again when closed, with the index
+	recorder->file = fopen(path, "wb");
+	if (!recorder->file || fwrite(&recorder->header, sizeof(recorder->header), 1, recorder->file) != 1
+		|| !ijk_issuccess(ijkThreadCreate(&recorder->thread, ijkRecorderRun, recorder)))
+	{
+		if (recorder->file)
+			fclose(recorder->file);
+		free(recorder->queue);
+		free(recorder->prev);
+		free(recorder->buffer);
+		*recorder = reset;
+		return ijk_failcodespec(ijk_fail_recording_open);
+	}
+	recorder->offset = sizeof(recorder->header);
+	return ijk_success;
+}
+
+
+byte* ijkRecorderBegin(ijkRecorder* const recorder)
+{
+	// the writer is behind by a full queue: wait for it rather than drop
+	i32 const queued = recorder->queued;
+	while (queued - ijkThreadAtomicLoad(&recorder->written) >= ijkRecordingQueue)
+		ijkThreadYield();
+	return (recorder->queue + (size_t)((ui32)queued % ijkRecordingQueue) * ijkRecordingCells(&recorder->header));
+}
+
+
+void ijkRecorderEnd(ijkRecorder* const recorder, ui32 const frame)
+{
+	i32 const queued = recorder->queued;
+	recorder->queueFrame[(ui32)queued % ijkRecordingQueue] = frame;
+	ijkThreadAtomicStore(&recorder->queued, queued + 1);
+}
+
+
+iret ijkRecorderClose(ijkRecorder* const recorder)
+{
+	ijkRecorder const reset = { 0 };
+	bool failed;
+	ijk_assertparamptr(recorder);
+	ijk_assertparamptr(recorder->file);
+
+	ijkThreadAtomicStore(&recorder->closing, 1);
+	ijkThreadJoin(&recorder->thread);
+
+	// index follows the last record; header is only complete once it is
+	recorder->header.indexOffset = recorder->offset;
+	failed = recorder->failed
+		|| fwrite(recorder->index, sizeof(*recorder->index), recorder->header.keyframes, recorder->file) != recorder->header.keyframes
+		|| fseek(recorder->file, 0, SEEK_SET) != 0
+		|| fwrite(&recorder->header, sizeof(recorder->header), 1, recorder->file) != 1;
+	failed = (fclose(recorder->file) != 0) || failed;
+	free(recorder->queue);
+	free(recorder->prev);
+	free(recorder->buffer);
+	free(recorder->index);
+	*recorder = reset;
+	return (failed ? ijk_failcodespec(ijk_fail_recording_open) : ijk_success);
+}
+
+
+iret ijkPlaybackOpen(ijkPlayback* const playback, kstr const path)
+{
+	ijkRecordingHeader const* header;
+	iret status;
+	ijk_assertparamptr(playback);
+	ijk_assertparamstr(path);
+	ijk_assertparamnull(playback->map.data);
+
+	status = ijkMapOpen(&playback->map, path, false);
+	if (!ijk_issuccess(status))
+		return status;
+	header = (ijkRecordingHeader const*)playback->map.data;
+	if (playback->map.size < sizeof(*header) || header->magic != ijkRecordingMagic || header->version != ijkRecordingVersion
+		|| !header->width || !header->height || !header->keyInterval || header->indexOffset < sizeof(*header)
+		|| header->indexOffset + (ui64)header->keyframes * sizeof(ijkRecordingIndex) > playback->map.size)
+	{
+		ijkMapRelease(&playback->map);
+		return ijk_failcodespec(ijk_fail_recording_format);
+	}
+	playback->header = *header;
+	playback->cursor = playback->map.data + sizeof(*header);
+	playback->end = playback->map.data + header->indexOffset;
+	playback->record = 0;
+	return ijk_success;
+}
+
+
+iret ijkPlaybackRelease(ijkPlayback* const playback)
+{
+	ijk_assertparamptr(playback);
+	ijk_assertparamptr(playback->map.data);
+
+	ijkMapRelease(&playback->map);
+	playback->cursor = playback->end = 0;
+	return ijk_success;
+}
+
+
+iret ijkPlaybackNext(ijkPlayback* const playback, byte* const cells, ui32* const frame_out_opt)
+{
+	ijkRecordingFrame record;
+	ijk_assertparamptr(playback);
+	ijk_assertparamptr(cells);
+
+	if (playback->cursor >= playback->end)
+		return ijk_failcodespec(ijk_fail_recording_end);
+	if ((size_t)(playback->end - playback->cursor) < sizeof(record))
+		return ijk_failcodespec(ijk_fail_recording_format);
+	memcpy(&record, playback->cursor, sizeof(record));
+	if (record.size > (size_t)(playback->end - playback->cursor) - sizeof(record))
+		return ijk_failcodespec(ijk_fail_recording_format);
+	playback->cursor += sizeof(record);
+	if (!ijkRecordingDecode(cells, ijkRecordingCells(&playback->header), playback->cursor, playback->cursor + record.size))
+		return ijk_failcodespec(ijk_fail_recording_format);
+	playback->cursor += record.size;
+	++playback->record;
+	if (frame_out_opt)
+		*frame_out_opt = record.frame;
+	return ijk_success;
+}
+
+
+iret ijkPlaybackSeek(ijkPlayback* const playback, ui32 const record, byte* const cells)
+{
+	ijkRecordingIndex key;
+	ui32 first = 0, last, middle;
+	iret status;
+	ijk_assertparamptr(playback);
+	ijk_assertparamptr(cells);
+	ijk_assertparam(record < playback->header.frames && playback->header.keyframes);
+
+	// last keyframe at or before record; the first record is always one
+	last = playback->header.keyframes - 1;
+	while (first < last)
+	{
+		middle = (first + last + 1) / 2;
+		memcpy(&key, playback->map.data + playback->header.indexOffset + (size_t)middle * sizeof(key), sizeof(key));
+		if (key.record <= record)
+			first = middle;
+		else
+			last = middle - 1;
+	}
+	memcpy(&key, playback->map.data + playback->header.indexOffset + (size_t)first * sizeof(key), sizeof(key));
+	if (key.offset < sizeof(ijkRecordingHeader) || key.offset >= playback->header.indexOffset)
+		return ijk_failcodespec(ijk_fail_recording_format);
+	playback->cursor = playback->map.data + key.offset;
+	playback->record = key.record;
+	do
+	{
+		status = ijkPlaybackNext(playback, cells, 0);
+		if (!ijk_issuccess(status))
+			return status;
+	} while (playback->record <= record);
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,235 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkRecording.h
+	Frame recording interface: frames of cells (one color byte each) are
+		stored as keyframes and deltas against the previous frame, both as
+		runs of one color after a count of unchanged cells; an index of
+		keyframes at the end allows seeking. Recording encodes and writes
+		on a thread of its own; playback maps the file.
+	-> file: header, then per frame a record header and its runs, then
+		the index; runs are (skip, length, color), counts as variable-
+		length integers (seven bits per byte, low first).
+*/
+
+#ifndef _IJK_RECORDING_H_
+#define _IJK_RECORDING_H_
+
+#include "ijkMap.h"
+#include "ijkThread.h"
+
+#include <stdio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkRecording)
+{
+	ijk_fail_recording_open,	// Failure with recording file open or write.
+	ijk_fail_recording_format,	// Failure with recording layout (magic, version or records).
+	ijk_fail_recording_end,		// Failure with playback past last frame.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkRecordingMagic
+//	Tag at start of recording ("ijRD" in memory).
+#define ijkRecordingMagic			0x44526a69
+
+// ijkRecordingVersion
+//	Layout version; playback refuses other versions.
+#define ijkRecordingVersion			1
+
+// ijkRecordingQueue
+//	Frames queued for recording thread before producer waits.
+#define ijkRecordingQueue			32
+
+// ijkRecordingHeader
+//	Header at start of recording.
+IJK_DECL_STRUCT(ijkRecordingHeader)
+{
+	ui32 magic;					// Tag.
+	ui32 version;				// Layout version.
+	ui16 width, height;			// Cells per row and rows per frame.
+	ui32 keyInterval;			// Frames from one keyframe to the next.
+	ui32 frames;				// Frame records (stored when closed).
+	ui32 keyframes;				// Index entries (stored when closed).
+	ui64 indexOffset;			// Offset of index in file; zero if not closed.
+};
+
+// ijkRecordingFrame
+//	Header of frame record; runs follow.
+IJK_DECL_STRUCT(ijkRecordingFrame)
+{
+	ui32 frame;					// Frame number given by producer.
+	ui32 size;					// Bytes of runs.
+	ui32 key;					// Non-zero if keyframe (runs cover every cell).
+};
+
+// ijkRecordingIndex
+//	Index entry per keyframe.
+IJK_DECL_STRUCT(ijkRecordingIndex)
+{
+	ui32 record;				// Ordinal of record in recording.
+	ui32 frame;					// Frame number of record.
+	ui64 offset;				// Offset of record in file.
+};
+
+// ijkRecorder
+//	Descriptor for recording in progress: the producer fills queued frames,
+//		which the recording thread encodes and writes in order.
+IJK_DECL_STRUCT(ijkRecorder)
+{
+	FILE* file;					// Recording file; null if not recording.
+	ijkThread thread;			// Recording thread.
+	ijkRecordingHeader header;	// Header stored when closed.
+	byte* queue;				// Cells per queued frame.
+	ui32 queueFrame[ijkRecordingQueue];	// Frame number per queued frame.
+	byte* prev;					// Cells of frame last written (thread only).
+	byte* buffer;				// Runs of frame being written (thread only).
+	ijkRecordingIndex* index;	// Index entries (thread only).
+	ui32 indexCapacity;			// Index entries allocated.
+	ui64 offset;				// Bytes written.
+	ui64 bytes;					// Bytes of runs written.
+	bool failed;				// Write or allocation failed (frames are dropped).
+	i32 volatile queued;		// Frames handed to thread.
+	i32 volatile written;		// Frames written by thread.
+	i32 volatile closing;		// Non-zero once producer stops.
+};
+
+// ijkPlayback
+//	Descriptor for recording being played.
+IJK_DECL_STRUCT(ijkPlayback)
+{
+	ijkMap map;					// Mapped recording.
+	ijkRecordingHeader header;	// Copy of header.
+	byte const* cursor;			// Next record.
+	byte const* end;			// End of records (start of index).
+	ui32 record;				// Ordinal of next record.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkRecorderOpen
+//	Create recording file and start recording thread.
+//		param recorder: pointer to descriptor that stores recording
+//			valid: non-null, not recording
+//		param path: path of recording
+//			valid: non-null, non-empty
+//		param width: cells per row
+//			valid: non-zero
+//		param height: rows per frame
+//			valid: non-zero
+//		param keyInterval: frames from one keyframe to the next
+//			valid: non-zero
+//		return SUCCESS: ijk_success if recording started
+//		return FAILURE: ijk_fail_specified if file or thread not created
+//		return FAILURE: ijk_fail_allocation if buffers not allocated
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkRecorderOpen(ijkRecorder* const recorder, kstr const path, ui16 const width, ui16 const height, ui32 const keyInterval);
+
+// ijkRecorderBegin
+//	Claim queue slot for next frame, waiting while queue is full.
+//		param recorder: pointer to descriptor that stores recording
+//			valid: non-null, recording
+//		return: cells of slot to fill (width times height, row-major)
+byte* ijkRecorderBegin(ijkRecorder* const recorder);
+
+// ijkRecorderEnd
+//	Hand frame claimed with ijkRecorderBegin to recording thread.
+//		param recorder: pointer to descriptor that stores recording
+//			valid: non-null, recording
+//		param frame: frame number stored with frame
+void ijkRecorderEnd(ijkRecorder* const recorder, ui32 const frame);
+
+// ijkRecorderClose
+//	Write queued frames, index and header; stop thread and close file.
+//		param recorder: pointer to descriptor that stores recording
+//			valid: non-null, recording
+//		return SUCCESS: ijk_success if every frame was written
+//		return FAILURE: ijk_fail_specified if any write failed
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkRecorderClose(ijkRecorder* const recorder);
+
+// ijkPlaybackOpen
+//	Map recording for playback from first frame.
+//		param playback: pointer to descriptor that stores playback
+//			valid: non-null, not mapped
+//		param path: path of recording
+//			valid: non-null, non-empty
+//		return SUCCESS: ijk_success if recording mapped
+//		return FAILURE: ijk_fail_specified if not mapped, not closed or
+//			layout unknown
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPlaybackOpen(ijkPlayback* const playback, kstr const path);
+
+// ijkPlaybackRelease
+//	Unmap recording.
+//		param playback: pointer to descriptor that stores playback
+//			valid: non-null, mapped
+//		return SUCCESS: ijk_success if recording unmapped
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPlaybackRelease(ijkPlayback* const playback);
+
+// ijkPlaybackNext
+//	Apply next frame to cells.
+//		param playback: pointer to descriptor that stores playback
+//			valid: non-null, mapped
+//		param cells: cells holding previous frame, updated to next
+//			valid: non-null, width times height
+//		param frame_out_opt: optional pointer to frame number
+//		return SUCCESS: ijk_success if frame applied
+//		return FAILURE: ijk_fail_specified if no frames left or record
+//			malformed
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPlaybackNext(ijkPlayback* const playback, byte* const cells, ui32* const frame_out_opt);
+
+// ijkPlaybackSeek
+//	Bring cells to given record, from keyframe at or before it; playback
+//		continues after it.
+//		param playback: pointer to descriptor that stores playback
+//			valid: non-null, mapped
+//		param record: ordinal of record
+//			valid: less than frames recorded
+//		param cells: cells updated to record
+//			valid: non-null, width times height
+//		return SUCCESS: ijk_success if cells hold record
+//		return FAILURE: ijk_fail_specified if record malformed
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkPlaybackSeek(ijkPlayback* const playback, ui32 const record, byte* const cells);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_RECORDING_H_
\ No newline at end of file
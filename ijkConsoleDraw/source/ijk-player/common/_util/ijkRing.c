@@ -0,0 +1,173 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkRing.c
+	Shared-memory frame ring source.
+*/
+
+#include "ijkRing.h"
+#include "ijkThread.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Get slot holding sequence
+static ijkRingSlot* ijkRingGetSlot(ijkRing const* const ring, i32 const sequence)
+{
+	return (ijkRingSlot*)((byte*)ring + sizeof(ijkRing) + (size_t)((ui32)(sequence - 1) % ring->slots) * ring->slotSize);
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkRingCreate(ijkRingFile* const file, kstr const directory, ui16 const width, ui16 const height, ui32 const slots)
+{
+	iret status;
+	ijkRing* ring;
+	ui32 const pid = ijkMapGetProcessId();
+	ui64 const slotSize = (sizeof(ijkRingSlot) + (ui64)width * (ui64)height + ijkRingAlign - 1) / ijkRingAlign * ijkRingAlign;
+	ui64 const size = sizeof(ijkRing) + slotSize * (ui64)slots;
+	ijk_assertparamptr(file);
+	ijk_assertparamstr(directory);
+	ijk_assertparam(width && height && slots > 1 && size <= 0xffffffff);
+	ijk_assertparamnull(file->ring);
+
+	sprintf(file->path, "%.200s/" ijkRingPrefix "%u", directory, pid);
+	status = ijkMapCreate(&file->map, file->path, (size_t)size);
+	if (!ijk_issuccess(status))
+		return status;
+
+	// consumers refuse the file until the tag is stored
+	ring = (ijkRing*)file->map.data;
+	ring->version = ijkRingVersion;
+	ring->size = (ui32)size;
+	ring->pid = pid;
+	ring->width = width;
+	ring->height = height;
+	ring->slots = slots;
+	ring->slotSize = (ui32)slotSize;
+	ijkThreadAtomicStore((i32 volatile*)&ring->magic, (i32)ijkRingMagic);
+	file->ring = ring;
+	return ijk_success;
+}
+
+
+iret ijkRingOpen(ijkRingFile* const file, kstr const path)
+{
+	iret status;
+	ijkRing const* ring;
+	ijk_assertparamptr(file);
+	ijk_assertparamstr(path);
+	ijk_assertparamnull(file->ring);
+
+	status = ijkMapOpen(&file->map, path, false);
+	if (!ijk_issuccess(status))
+		return status;
+	ring = (ijkRing const*)file->map.data;
+	if (file->map.size < sizeof(ijkRing)
+		|| ijkThreadAtomicLoad((i32 volatile const*)&ring->magic) != (i32)ijkRingMagic
+		|| ring->version != ijkRingVersion || ring->size != file->map.size || ring->slots < 2
+		|| ring->slotSize < sizeof(ijkRingSlot) + (ui32)ring->width * (ui32)ring->height
+		|| (ui64)ring->slots * (ui64)ring->slotSize > (ui64)ring->size - sizeof(ijkRing))
+	{
+		ijkMapRelease(&file->map);
+		return ijk_failcodespec(ijk_fail_ring_format);
+	}
+	strncpy(file->path, path, sizeof(file->path) - 1);
+	file->ring = (ijkRing*)ring;
+	return ijk_success;
+}
+
+
+iret ijkRingRelease(ijkRingFile* const file)
+{
+	bool producer;
+	ijk_assertparamptr(file);
+	ijk_assertparamptr(file->ring);
+
+	// consumers still mapping the file finish what is there
+	producer = file->map.writable;
+	if (producer)
+		ijkThreadAtomicStore(&file->ring->closed, 1);
+	ijkMapRelease(&file->map);
+	if (producer)
+		remove(file->path);
+	file->ring = 0;
+	return ijk_success;
+}
+
+
+byte* ijkRingWriteBegin(ijkRing* const ring)
+{
+	// zero first, so the cells change only after the slot stops
+	//	matching the sequence consumers found in it
+	ijkRingSlot* const slot = ijkRingGetSlot(ring, ring->head + 1);
+	ijkThreadAtomicStore(&slot->sequence, 0);
+	return (byte*)(slot + 1);
+}
+
+
+i32 ijkRingWriteEnd(ijkRing* const ring, ui32 const frame)
+{
+	i32 const sequence = ring->head + 1;
+	ijkRingSlot* const slot = ijkRingGetSlot(ring, sequence);
+	slot->frame = frame;
+	ijkThreadAtomicStore(&slot->sequence, sequence);
+	ijkThreadAtomicStore(&ring->head, sequence);
+	return sequence;
+}
+
+
+i32 ijkRingReadBegin(ijkRing const* const ring, i32 const sequence, byte const** const cells_out, ui32* const frame_out_opt)
+{
+	ijkRingSlot const* slot;
+	i32 const head = ijkThreadAtomicLoad(&ring->head);
+	i32 next = ijk_maximum(sequence, 1);
+
+	// frames more than a ring behind are gone; one being rewritten is
+	//	skipped for the next
+	if (head - next >= (i32)ring->slots)
+		next = head - (i32)ring->slots + 1;
+	for (; next <= head; ++next)
+	{
+		slot = ijkRingGetSlot(ring, next);
+		if (ijkThreadAtomicLoad(&slot->sequence) == next)
+		{
+			*cells_out = (byte const*)(slot + 1);
+			if (frame_out_opt)
+				*frame_out_opt = slot->frame;
+			return next;
+		}
+	}
+	return 0;
+}
+
+
+bool ijkRingReadEnd(ijkRing const* const ring, i32 const sequence)
+{
+	return (ijkThreadAtomicLoad(&ijkRingGetSlot(ring, sequence)->sequence) == sequence);
+}
+
+
+//-----------------------------------------------------------------------------
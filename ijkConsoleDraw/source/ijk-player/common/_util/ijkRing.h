@@ -0,0 +1,187 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkRing.h
+	Shared-memory frame ring interface: one producer writes frames of
+		cells (one color byte each) into a memory-mapped file of slots,
+		numbering them in sequence; consumers in other processes read
+		slots in place, and check afterwards that the slot was not
+		reused, so a slow consumer only sees gaps in the sequence and
+		the producer never waits.
+*/
+
+#ifndef _IJK_RING_H_
+#define _IJK_RING_H_
+
+#include "ijkMap.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkRing)
+{
+	ijk_fail_ring_format,		// Failure with ring layout (magic, version or size).
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkRingMagic
+//	Tag at start of ring file ("ijKR" in memory).
+#define ijkRingMagic				0x524b6a69
+
+// ijkRingVersion
+//	Layout version; consumers refuse other versions.
+#define ijkRingVersion				1
+
+// ijkRingPrefix
+//	Start of ring file names; process identifier follows.
+#define ijkRingPrefix				"ijk-ring-"
+
+// ijkRingAlign
+//	Alignment of header, slots and cells in bytes (cache line).
+#define ijkRingAlign				64
+
+// ijkRingSlot
+//	Header of frame slot; cells follow.
+IJK_DECL_STRUCT(ijkRingSlot)
+{
+	i32 volatile sequence;		// Sequence of frame in slot; zero while written.
+	ui32 frame;					// Frame number given by producer.
+	ui32 reserved[ijkRingAlign / 4 - 2];	// Alignment of cells.
+};
+
+// ijkRing
+//	Layout of ring file header; slots follow.
+IJK_DECL_STRUCT(ijkRing)
+{
+	ui32 magic;					// Tag, stored last when created.
+	ui32 version;				// Layout version.
+	ui32 size;					// Bytes of file.
+	ui32 pid;					// Process identifier of producer.
+	ui16 width, height;			// Cells per row and rows per frame.
+	ui32 slots;					// Frame slots.
+	ui32 slotSize;				// Bytes per slot, header and cells.
+	i32 volatile head;			// Sequence of newest frame; zero if none.
+	i32 volatile closed;		// Non-zero once producer stopped.
+	ui32 reserved[ijkRingAlign / 4 - 9];	// Alignment of slots.
+};
+
+// ijkRingFile
+//	Descriptor for ring file of producer or consumer.
+IJK_DECL_STRUCT(ijkRingFile)
+{
+	ijkMap map;					// Mapped file.
+	ijkRing* ring;				// Header in mapped file; null if not mapped.
+	char path[256];				// Path of file, removed when producer releases.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkRingCreate
+//	Create ring file for this process in directory, as producer.
+//		param file: pointer to descriptor that stores ring file
+//			valid: non-null, not mapped
+//		param directory: directory of ring files
+//			valid: non-null, non-empty
+//		param width: cells per row
+//			valid: non-zero
+//		param height: rows per frame
+//			valid: non-zero
+//		param slots: frame slots; a consumer may fall this many frames
+//			behind before it skips any
+//			valid: greater than one
+//		return SUCCESS: ijk_success if file created
+//		return FAILURE: ijk_fail_specified if file not created (see ijkMap)
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkRingCreate(ijkRingFile* const file, kstr const directory, ui16 const width, ui16 const height, ui32 const slots);
+
+// ijkRingOpen
+//	Map existing ring file, as consumer.
+//		param file: pointer to descriptor that stores ring file
+//			valid: non-null, not mapped
+//		param path: path of ring file
+//			valid: non-null, non-empty
+//		return SUCCESS: ijk_success if file mapped
+//		return FAILURE: ijk_fail_specified if file not mapped or layout unknown
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkRingOpen(ijkRingFile* const file, kstr const path);
+
+// ijkRingRelease
+//	Unmap ring file; producer marks ring closed and removes file.
+//		param file: pointer to descriptor that stores ring file
+//			valid: non-null, mapped
+//		return SUCCESS: ijk_success if file released
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkRingRelease(ijkRingFile* const file);
+
+// ijkRingWriteBegin
+//	Claim slot for next frame (producer only); consumers reading the slot
+//		see it was reused.
+//		param ring: pointer to ring header
+//			valid: non-null, writable
+//		return: cells of slot to fill (width times height, row-major)
+byte* ijkRingWriteBegin(ijkRing* const ring);
+
+// ijkRingWriteEnd
+//	Publish frame claimed with ijkRingWriteBegin.
+//		param ring: pointer to ring header
+//			valid: non-null, writable
+//		param frame: frame number stored with frame
+//		return: sequence of frame published
+i32 ijkRingWriteEnd(ijkRing* const ring, ui32 const frame);
+
+// ijkRingReadBegin
+//	Find oldest frame still in ring at or after sequence, for reading in
+//		place; frames before it were skipped.
+//		param ring: pointer to ring header
+//			valid: non-null
+//		param sequence: next sequence wanted (one for first)
+//		param cells_out: pointer to cells of frame found
+//			valid: non-null
+//		param frame_out_opt: optional pointer to frame number of frame found
+//		return: sequence of frame found; zero if none yet
+i32 ijkRingReadBegin(ijkRing const* const ring, i32 const sequence, byte const** const cells_out, ui32* const frame_out_opt);
+
+// ijkRingReadEnd
+//	Check that frame found with ijkRingReadBegin was not reused while read.
+//		param ring: pointer to ring header
+//			valid: non-null
+//		param sequence: sequence of frame read
+//		return: true if cells read are intact
+bool ijkRingReadEnd(ijkRing const* const ring, i32 const sequence);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_RING_H_
\ No newline at end of file
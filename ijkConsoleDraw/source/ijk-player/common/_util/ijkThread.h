@@ -0,0 +1,142 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkThread.h
+	Thread and atomic counter interface.
+*/
+
+#ifndef _IJK_THREAD_H_
+#define _IJK_THREAD_H_
+
+#include "ijk/ijk/ijk-typedefs.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkThread)
+{
+	ijk_fail_thread_create,	// Failure with thread create.
+	ijk_fail_thread_join,	// Failure with thread join.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijk_threadlocal
+//	Qualifier for variable with separate instance per thread.
+#if (defined _MSC_VER)
+#define ijk_threadlocal				__declspec(thread)
+#else	// !_MSC_VER
+#define ijk_threadlocal				_Thread_local
+#endif	// _MSC_VER
+
+// ijkThreadFunc
+//	Entry point of thread.
+//		param args: pointer passed to thread on create
+//		return: result stored in thread descriptor on join
+typedef iret(*ijkThreadFunc)(ptr const args);
+
+// ijkThread
+//	Descriptor for thread.
+IJK_DECL_STRUCT(ijkThread)
+{
+	ptr handle;					// Platform handle; null if not running.
+	ijkThreadFunc func;			// Entry point.
+	ptr args;					// Pointer passed to entry point.
+	iret result;				// Result of entry point once joined.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkThreadCreate
+//	Create and start thread.
+//		param thread: pointer to descriptor that stores thread info
+//			valid: non-null, not running
+//		param func: entry point of thread
+//			valid: non-null
+//		param args: pointer passed to entry point
+//		return SUCCESS: ijk_success if thread started
+//		return FAILURE: ijk_fail_specified if thread not started
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkThreadCreate(ijkThread* const thread, ijkThreadFunc const func, ptr const args);
+
+// ijkThreadJoin
+//	Wait for thread to finish, store its result and release it.
+//		param thread: pointer to descriptor that stores thread info
+//			valid: non-null, running
+//		return SUCCESS: ijk_success if thread joined
+//		return FAILURE: ijk_fail_specified if thread could not be joined
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkThreadJoin(ijkThread* const thread);
+
+// ijkThreadYield
+//	Give up the rest of the calling thread's time slice.
+void ijkThreadYield();
+
+// ijkThreadSleep
+//	Suspend the calling thread.
+//		param ms: milliseconds to sleep, at least
+void ijkThreadSleep(ui32 const ms);
+
+// ijkThreadGetCores
+//	Get number of logical processors.
+//		return: number of logical processors; at least one
+ui32 ijkThreadGetCores();
+
+// ijkThreadAtomicIncrement
+//	Increment shared value as one indivisible operation (full barrier).
+//		param value: pointer to shared value
+//			valid: non-null, aligned
+//		return: incremented value
+i32 ijkThreadAtomicIncrement(i32 volatile* const value);
+
+// ijkThreadAtomicLoad
+//	Read shared value, ordered after writes published before it was stored
+//		(full barrier); only reads, so the value may be in memory mapped 
+//		read-only.
+//		param value: pointer to shared value
+//			valid: non-null, aligned
+//		return: current value
+i32 ijkThreadAtomicLoad(i32 volatile const* const value);
+
+// ijkThreadAtomicStore
+//	Write shared value, publishing every write made before it (full barrier).
+//		param value: pointer to shared value
+//			valid: non-null, aligned
+//		param store: new value
+void ijkThreadAtomicStore(i32 volatile* const value, i32 const store);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_THREAD_H_
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkThread_win.c
+	Thread and atomic counter source for Windows.
+*/
+
+#include "ijkThread.h"
+#if ijk_platform_is(WINDOWS)
+
+#include <Windows.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Windows entry point forwarding to descriptor's function
+static DWORD WINAPI ijkThreadProc(LPVOID args)
+{
+	ijkThread* const thread = (ijkThread*)args;
+	thread->result = thread->func(thread->args);
+	return 0;
+}
+
+
+iret ijkThreadCreate(ijkThread* const thread, ijkThreadFunc const func, ptr const args)
+{
+	ijk_assertparamptr(thread);
+	ijk_assertparamptr(func);
+	ijk_assertparam(!thread->handle);
+
+	thread->func = func;
+	thread->args = args;
+	thread->result = ijk_success;
+	thread->handle = CreateThread(NULL, 0, ijkThreadProc, thread, 0, NULL);
+	ijk_assertspectrue(thread->handle, ijk_fail_thread_create);
+	return ijk_success;
+}
+
+
+iret ijkThreadJoin(ijkThread* const thread)
+{
+	ijk_assertparamptr(thread);
+	ijk_assertparamptr(thread->handle);
+
+	bln const completed = WaitForSingleObject(thread->handle, INFINITE) == WAIT_OBJECT_0;
+	ijk_assertspectrue(completed, ijk_fail_thread_join);
+	CloseHandle(thread->handle);
+	thread->handle = NULL;
+	return ijk_success;
+}
+
+
+void ijkThreadYield()
+{
+	SwitchToThread();
+}
+
+
+void ijkThreadSleep(ui32 const ms)
+{
+	Sleep(ms);
+}
+
+
+ui32 ijkThreadGetCores()
+{
+	SYSTEM_INFO info[1];
+	GetSystemInfo(info);
+	return (info->dwNumberOfProcessors > 0 ? (ui32)info->dwNumberOfProcessors : 1);
+}
+
+
+//-----------------------------------------------------------------------------
+
+i32 ijkThreadAtomicIncrement(i32 volatile* const value)
+{
+	return (i32)InterlockedIncrement((LONG volatile*)value);
+}
+
+
+i32 ijkThreadAtomicLoad(i32 volatile const* const value)
+{
+	// plain read between barriers: an interlocked operation always writes, 
+	//	which faults on memory mapped read-only
+	i32 load;
+	MemoryBarrier();
+	load = *value;
+	MemoryBarrier();
+	return load;
+}
+
+
+void ijkThreadAtomicStore(i32 volatile* const value, i32 const store)
+{
+	InterlockedExchange((LONG volatile*)value, (LONG)store);
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
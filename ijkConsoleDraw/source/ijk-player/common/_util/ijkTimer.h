@@ -0,0 +1,103 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkTimer.h
+	High-resolution timer interface.
+*/
+
+#ifndef _IJK_TIMER_H_
+#define _IJK_TIMER_H_
+
+#include "ijk/ijk/ijk-typedefs.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+IJK_FAILURELIST(ijkTimer)
+{
+	ijk_fail_timer_init,	// Failure with timer init.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkTimer
+//	Descriptor for high-resolution timer.
+IJK_DECL_STRUCT(ijkTimer)
+{
+	i64 frequency;				// Ticks per second.
+	i64 tick;					// Tick count when timer was last started.
+};
+
+
+//-----------------------------------------------------------------------------
+
+// ijkTimerInit
+//	Initialize timer and start it.
+//		param timer: pointer to descriptor that stores timer info
+//			valid: non-null
+//		return SUCCESS: ijk_success if timer initialized
+//		return FAILURE: ijk_fail_specified if high-resolution timer unavailable
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkTimerInit(ijkTimer* const timer);
+
+// ijkTimerStart
+//	Restart timer from current time.
+//		param timer: pointer to descriptor that stores timer info
+//			valid: non-null, initialized
+//		return SUCCESS: ijk_success if timer started
+//		return FAILURE: ijk_fail_invalidparam if invalid parameters
+iret ijkTimerStart(ijkTimer* const timer);
+
+// ijkTimerElapsed
+//	Get time since timer was last started.
+//		param timer: pointer to descriptor that stores timer info
+//			valid: non-null, initialized
+//		return: elapsed time in seconds; zero if invalid parameters
+f64 ijkTimerElapsed(ijkTimer const* const timer);
+
+// ijkTimerLap
+//	Get time since timer was last started and restart it.
+//		param timer: pointer to descriptor that stores timer info
+//			valid: non-null, initialized
+//		return: elapsed time in seconds; zero if invalid parameters
+f64 ijkTimerLap(ijkTimer* const timer);
+
+// ijkTimerCycles
+//	Get processor time-stamp counter, for counting cycles between two reads.
+//		return: counter value; zero if processor has no counter
+ui64 ijkTimerCycles(void);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_IJK_TIMER_H_
\ No newline at end of file
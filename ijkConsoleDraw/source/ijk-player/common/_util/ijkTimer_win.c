@@ -0,0 +1,96 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	ijkTimer_win.c
+	High-resolution timer source for Windows.
+*/
+
+#include "ijkTimer.h"
+#if ijk_platform_is(WINDOWS)
+
+#include <Windows.h>
+#include <intrin.h>
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkTimerInit(ijkTimer* const timer)
+{
+	ijk_assertparamptr(timer);
+
+	LARGE_INTEGER frequency[1];
+	bln const completed = QueryPerformanceFrequency(frequency) && frequency->QuadPart > 0;
+	ijk_assertspectrue(completed, ijk_fail_timer_init);
+
+	timer->frequency = frequency->QuadPart;
+	return ijkTimerStart(timer);
+}
+
+
+iret ijkTimerStart(ijkTimer* const timer)
+{
+	ijk_assertparamptr(timer);
+
+	LARGE_INTEGER tick[1];
+	QueryPerformanceCounter(tick);
+	timer->tick = tick->QuadPart;
+	return ijk_success;
+}
+
+
+f64 ijkTimerElapsed(ijkTimer const* const timer)
+{
+	ijk_assertptr(timer, 0.0);
+	ijk_assertneq0(timer->frequency, 0.0);
+
+	LARGE_INTEGER tick[1];
+	QueryPerformanceCounter(tick);
+	return (f64)(tick->QuadPart - timer->tick) / (f64)timer->frequency;
+}
+
+
+f64 ijkTimerLap(ijkTimer* const timer)
+{
+	ijk_assertptr(timer, 0.0);
+	ijk_assertneq0(timer->frequency, 0.0);
+
+	LARGE_INTEGER tick[1];
+	QueryPerformanceCounter(tick);
+	f64 const elapsed = (f64)(tick->QuadPart - timer->tick) / (f64)timer->frequency;
+	timer->tick = tick->QuadPart;
+	return elapsed;
+}
+
+
+ui64 ijkTimerCycles(void)
+{
+#if (defined _M_IX86 || defined _M_X64)
+	return __rdtsc();
+#else	// !x86
+	return 0;
+#endif	// x86
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// WINDOWS
\ No newline at end of file
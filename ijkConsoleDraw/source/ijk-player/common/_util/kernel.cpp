@@ -0,0 +1,269 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	kernel.cpp
+	Specialized ray kernel implementation.
+	-> each kernel is a template instance whose projection, shape set and 
+		shading model are compile-time constants, so the inner loop keeps 
+		only the work its options need (e.g. a perspective ray's origin is 
+		the viewer, unused shape loops and shadow rays disappear)
+	-> ray tests, normals and shading constants are shared with the 
+		renderer (shape.inl), so the full perspective kernel matches its 
+		output
+*/
+
+#include "kernel.h"
+
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+	// Ray in scene
+	struct sKernelRay
+	{
+		vec3f origin;
+		vec3f direction;
+	};
+
+	// Closest hit ('type' is shape_none on a miss)
+	struct sKernelHit
+	{
+		ui32 type, index;
+		float_t dist;
+	};
+
+
+	//-------------------------------------------------------------------------
+
+	// Rotate vector from viewer's space to scene
+	inline floatv_t fKernelRotateToScene(sKernelFrame const& frame, float3_t v_out, float3_t const v_eye)
+	{
+		float3_t const v = {
+			v_eye[0] * frame.yawCos + v_eye[2] * frame.yawSin,
+			v_eye[1],
+			v_eye[2] * frame.yawCos - v_eye[0] * frame.yawSin,
+		};
+		return vec3fCopy(v_out, v);
+	}
+
+	// Primary rays per projection, given viewport coord in viewer's space
+	template <eKernelProjection projection>
+	struct tKernelProjection;
+
+	template <>
+	struct tKernelProjection<kernel_persp>
+	{
+		static void init(sKernelRay& ray, sKernelFrame const& frame, float3_t const coord)
+		{
+			vec3fCopy(ray.origin.v, frame.origin.v);
+			fKernelRotateToScene(frame, ray.direction.v, coord);
+		}
+	};
+
+	template <>
+	struct tKernelProjection<kernel_ortho>
+	{
+		static void init(sKernelRay& ray, sKernelFrame const& frame, float3_t const coord)
+		{
+			float3_t const forward = { 0.0f, 0.0f, coord[2] };
+			fKernelRotateToScene(frame, ray.origin.v, coord);
+			vec3fAdd(ray.origin.v, ray.origin.v, frame.origin.v);
+			fKernelRotateToScene(frame, ray.direction.v, forward);
+		}
+	};
+
+	// Shape types tested per shape set
+	template <eKernelShapes shapes>
+	struct tKernelShapes
+	{
+		static bool const spheres = (shapes != kernel_cylinders);
+		static bool const cylinders = (shapes != kernel_spheres);
+	};
+
+
+	//-------------------------------------------------------------------------
+
+	// Test ray against sphere
+	inline bool fKernelTestSphere(sKernelRay const& ray, sScene const* const scene, ui32 const shapeIndex, sKernelHit& hit_out)
+	{
+		if (!fShapeSolveSphere(scene, shapeIndex, ray.origin.v, ray.direction.v, &hit_out.dist))
+			return false;
+		hit_out.type = shape_sphere;
+		hit_out.index = shapeIndex;
+		return true;
+	}
+
+	// Test ray against finite cylinder
+	inline bool fKernelTestCylinder(sKernelRay const& ray, sScene const* const scene, ui32 const shapeIndex, sKernelHit& hit_out)
+	{
+		if (!fShapeSolveCylinder(scene, shapeIndex, ray.origin.v, ray.direction.v, &hit_out.dist))
+			return false;
+		hit_out.type = shape_cylinder;
+		hit_out.index = shapeIndex;
+		return true;
+	}
+
+	// Test ray against shape of shape set
+	template <eKernelShapes shapes>
+	inline bool fKernelTestShape(sKernelRay const& ray, sScene const* const scene, sShapeRef const& shape, sKernelHit& hit_out)
+	{
+		if (shape.type == shape_sphere)
+			return (tKernelShapes<shapes>::spheres && fKernelTestSphere(ray, scene, shape.index, hit_out));
+		return (tKernelShapes<shapes>::cylinders && fKernelTestCylinder(ray, scene, shape.index, hit_out));
+	}
+
+	// Test ray against shape set, keeping closest hit
+	//	-> only listed shapes are tested if there is a list
+	template <eKernelShapes shapes>
+	inline void fKernelTestClosest(sKernelRay const& ray, sScene const* const scene, sShapeRef const* const shape, ui32 const count, sKernelHit& hit_out)
+	{
+		sKernelHit hit;
+		ui32 i;
+		hit_out.type = shape_none;
+		hit_out.index = 0;
+		hit_out.dist = 0.0f;
+		if (shape)
+		{
+			for (i = 0; i < count; ++i)
+				if (fKernelTestShape<shapes>(ray, scene, shape[i], hit) && (hit_out.type == shape_none || hit.dist < hit_out.dist))
+					hit_out = hit;
+			return;
+		}
+		if (tKernelShapes<shapes>::spheres)
+			for (i = 0; i < scene->numSpheres; ++i)
+				if (fKernelTestSphere(ray, scene, i, hit) && (hit_out.type == shape_none || hit.dist < hit_out.dist))
+					hit_out = hit;
+		if (tKernelShapes<shapes>::cylinders)
+			for (i = 0; i < scene->numCylinders; ++i)
+				if (fKernelTestCylinder(ray, scene, i, hit) && (hit_out.type == shape_none || hit.dist < hit_out.dist))
+					hit_out = hit;
+	}
+
+	// Test ray against shape set for any hit before a distance
+	template <eKernelShapes shapes>
+	inline bool fKernelTestAny(sKernelRay const& ray, sScene const* const scene, float_t const distMax)
+	{
+		sKernelHit hit;
+		ui32 i;
+		if (tKernelShapes<shapes>::spheres)
+			for (i = 0; i < scene->numSpheres; ++i)
+				if (fKernelTestSphere(ray, scene, i, hit) && hit.dist < distMax)
+					return true;
+		if (tKernelShapes<shapes>::cylinders)
+			for (i = 0; i < scene->numCylinders; ++i)
+				if (fKernelTestCylinder(ray, scene, i, hit) && hit.dist < distMax)
+					return true;
+		return false;
+	}
+
+
+	//-------------------------------------------------------------------------
+
+	// Calculate shaded color of closest hit per shading model
+	template <eKernelShapes shapes, eKernelShading shading>
+	inline ijkConsoleColor fKernelShade(sKernelHit const& hit, sKernelRay const& ray, sScene const* const scene)
+	{
+		vec3f point, normal, light;
+		sColor color;
+		sKernelRay shadow;
+
+		if (hit.type == shape_none)
+			return scene->color_bg;
+		if (hit.type == shape_sphere)
+			fSphereGetColor(scene, hit.index, &color);
+		else
+			fCylinderGetColor(scene, hit.index, &color);
+		if (shading == kernel_flat)
+			return color.color[1];
+
+		vec3fMad(point.v, ray.origin.v, ray.direction.v, hit.dist);
+		fShapeGetNormal(scene, hit.type, hit.index, point.v, normal.v);
+		fPointLightGet(scene, 0, &light);
+		if (fShapeCalcLambert(point.v, normal.v, light.v, shadow.direction.v) <= shade_lambertLight)
+			return color.color[0];
+		if (shading == kernel_lambert)
+			return color.color[1];
+
+		shadow.origin = point;
+		return color.color[!fKernelTestAny<shapes>(shadow, scene, 1.0f)];
+	}
+
+	// Trace and shade every pixel of frame
+	template <eKernelProjection projection, eKernelShapes shapes, eKernelShading shading>
+	void fKernelTrace(sKernelFrame const* const frame)
+	{
+		sKernelRay ray;
+		sKernelHit hit;
+		sShapeRef const* shape = 0;
+		float3_t coord;
+		ui16 x, y;
+		ui32 i, tile, count = 0;
+		float_t const widthInv = 1.0f / (float_t)frame->width, heightInv = 1.0f / (float_t)frame->height;
+
+		coord[2] = -frame->viewDist;
+		for (y = 0, i = 0; y < frame->height; ++y)
+		{
+			float_t const v = (float_t)(frame->height - 1 - y) * heightInv;
+			coord[1] = (v * 2.0f - 1.0f) * 0.5f * frame->viewHeight;
+			for (x = 0; x < frame->width; ++x, ++i)
+			{
+				float_t const u = (float_t)(x) * widthInv;
+				coord[0] = (u * 2.0f - 1.0f) * 0.5f * frame->viewWidth;
+				tKernelProjection<projection>::init(ray, *frame, coord);
+				if (frame->bin)
+				{
+					tile = (ui32)(y / frame->tileSize) * (ui32)frame->tilesX + (ui32)(x / frame->tileSize);
+					shape = frame->bin + frame->offset[tile];
+					count = frame->offset[tile + 1] - frame->offset[tile];
+				}
+				fKernelTestClosest<shapes>(ray, frame->scene, shape, count, hit);
+				frame->color[i] = fKernelShade<shapes, shading>(hit, ray, frame->scene);
+			}
+		}
+	}
+
+
+	//-------------------------------------------------------------------------
+
+	// Dispatch table of every kernel
+#define kernel_shadings(projection, shapes) { fKernelTrace<projection, shapes, kernel_flat>, fKernelTrace<projection, shapes, kernel_lambert>, fKernelTrace<projection, shapes, kernel_shadowed> }
+#define kernel_shapeSets(projection) { kernel_shadings(projection, kernel_spheres), kernel_shadings(projection, kernel_cylinders), kernel_shadings(projection, kernel_shapesAll) }
+	fKernelFrame const kernelTable[kernel_projectionCount][kernel_shapesCount][kernel_shadingCount] = {
+		kernel_shapeSets(kernel_persp),
+		kernel_shapeSets(kernel_ortho),
+	};
+#undef kernel_shapeSets
+#undef kernel_shadings
+}
+
+
+//-----------------------------------------------------------------------------
+
+fKernelFrame fKernelGet(eKernelProjection const projection, eKernelShapes const shapes, eKernelShading const shading)
+{
+	if (projection < 0 || projection >= kernel_projectionCount || shapes < 0 || shapes >= kernel_shapesCount || shading < 0 || shading >= kernel_shadingCount)
+		return 0;
+	return kernelTable[projection][shapes][shading];
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,101 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	kernel.h
+	Specialized ray kernel interface (implemented in C++).
+*/
+
+#ifndef _KERNEL_H_
+#define _KERNEL_H_
+
+#include "shape.inl"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// Kernel projections
+typedef enum eKernelProjection_t
+{
+	kernel_persp,				// Rays leave the viewer through the viewport
+	kernel_ortho,				// Rays leave the viewport straight ahead
+	kernel_projectionCount
+} eKernelProjection;
+
+// Kernel shape sets
+typedef enum eKernelShapes_t
+{
+	kernel_spheres,				// Spheres only
+	kernel_cylinders,			// Cylinders only
+	kernel_shapesAll,			// Spheres and cylinders
+	kernel_shapesCount
+} eKernelShapes;
+
+// Kernel shading models
+typedef enum eKernelShading_t
+{
+	kernel_flat,				// Light color of hit shape
+	kernel_lambert,				// Light or dark by Lambertian coefficient
+	kernel_shadowed,			// Lambertian, dark if light is blocked
+	kernel_shadingCount
+} eKernelShading;
+
+// Kernel frame descriptor
+//	-> view matches the renderer's viewport and camera: viewer at 'origin' 
+//		turned by 'yaw' about scene y, viewport plane at 'viewDist'
+//	-> primary rays test the shapes binned to their pixel's tile if lists 
+//		are given, otherwise every shape; shadow rays test every shape
+typedef struct sKernelFrame_t
+{
+	sScene const* scene;		// Scene to trace
+	vec3f origin;				// Location of viewer in scene
+	float_t yawCos, yawSin;		// Cosine and sine of viewer's yaw
+	float_t viewWidth;			// Width of viewport in viewer space
+	float_t viewHeight;			// Height of viewport in viewer space
+	float_t viewDist;			// Distance to viewport in viewer space
+	ui16 width, height;			// Dimensions of frame in pixels
+	ijkConsoleColor* color;		// Final color per pixel (row-major)
+	sShapeRef const* bin;		// Shapes per tile, packed (null tests every shape)
+	ui32 const* offset;			// First entry per tile, plus end of last tile
+	ui16 tileSize, tilesX;		// Tile size in pixels and number of tiles across
+} sKernelFrame;
+
+// Kernel tracing and shading every pixel of frame
+typedef void(*fKernelFrame)(sKernelFrame const* const frame);
+
+// Get kernel specialized for projection, shape set and shading model
+//	-> returns null if any option is out of range
+fKernelFrame fKernelGet(eKernelProjection const projection, eKernelShapes const shapes, eKernelShading const shading);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_KERNEL_H_
\ No newline at end of file
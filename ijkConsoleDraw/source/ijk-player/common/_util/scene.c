@@ -25,12 +25,167 @@
 
 #include "scene.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// Alignment of scene block in binary scene file (cache line)
+#define scene_fileAlign	64
+
+// Names of colors in text scenes, by index
+static kstr const sceneColorName[16] = {
+	"black", "blue_d", "green_d", "cyan_d", "red_d", "magenta_d", "yellow_d", "grey",
+	"grey_d", "blue", "green", "cyan", "red", "magenta", "yellow", "white",
+};
+
+// Size of scene block for number of each shape
+//	-> 64-bit, so counts too large to address cannot wrap to a small size
+static ui64 fSceneLayoutSize(ui32 const numSpheres, ui32 const numCylinders, ui32 const numPointLights)
+{
+	ui64 const numLocations = (ui64)numSpheres + (ui64)numCylinders * 2 + (ui64)numPointLights;
+	ui64 const numShapes = (ui64)numSpheres + (ui64)numCylinders;
+	return ((ui64)numSpheres * sizeof(sSphere) + (ui64)numCylinders * sizeof(sCylinder)
+		+ (ui64)numPointLights * sizeof(sPointLight) + numLocations * sizeof(vec3f)
+		+ numShapes * sizeof(float_t) + numShapes * sizeof(sColor));
+}
+
+// Point scene lists into block holding layout size for number of each shape
+static void fSceneLayout(sScene* const scene, byte* const data, ui32 const numSpheres, ui32 const numCylinders, ui32 const numPointLights)
+{
+	size_t const numLocations = (size_t)numSpheres + (size_t)numCylinders * 2 + (size_t)numPointLights;
+	size_t const numShapes = (size_t)numSpheres + (size_t)numCylinders;
+	size_t const size_sphere = numSpheres * sizeof(*scene->sphere);
+	size_t const size_cylinder = numCylinders * sizeof(*scene->cylinder);
+	size_t const size_pointLight = numPointLights * sizeof(*scene->pointLight);
+	size_t const size_location = numLocations * sizeof(*scene->location);
+	size_t const size_radius = numShapes * sizeof(*scene->radius);
+	size_t const size_color = numShapes * sizeof(*scene->color);
+	size_t const size = size_sphere + size_cylinder + size_pointLight + size_location + size_radius + size_color;
+
+	// lay out lists in block
+	scene->numSpheres = numSpheres;
+	scene->numCylinders = numCylinders;
+	scene->numPointLights = numPointLights;
+	scene->sphere = (sSphere*)(data);
+	scene->cylinder = (sCylinder*)(data + size_sphere);
+	scene->pointLight = (sPointLight*)(data + size_sphere + size_cylinder);
+	scene->location = (vec3f*)(data + size_sphere + size_cylinder + size_pointLight);
+	scene->radius = (float_t*)(data + size_sphere + size_cylinder + size_pointLight + size_location);
+	scene->color = (sColor*)(data + size_sphere + size_cylinder + size_pointLight + size_location + size_radius);
+	scene->color_bg = ijkConsoleColor_black;
+	scene->data = data;
+	scene->size = size;
+}
+
+// Check that every list entry links to values inside the scene
+static bool fSceneCheckLinks(sScene const* const scene)
+{
+	size_t const numLocations = (size_t)scene->numSpheres + (size_t)scene->numCylinders * 2 + (size_t)scene->numPointLights;
+	size_t const numShapes = (size_t)scene->numSpheres + (size_t)scene->numCylinders;
+	ui32 i;
+	for (i = 0; i < scene->numSpheres; ++i)
+		if (scene->sphere[i].i_location >= numLocations || scene->sphere[i].i_radius >= numShapes || scene->sphere[i].i_color >= numShapes)
+			return false;
+	for (i = 0; i < scene->numCylinders; ++i)
+		if (scene->cylinder[i].i_location_cap0 >= numLocations || scene->cylinder[i].i_location_cap1 >= numLocations ||
+			scene->cylinder[i].i_radius >= numShapes || scene->cylinder[i].i_color >= numShapes)
+			return false;
+	for (i = 0; i < scene->numPointLights; ++i)
+		if (scene->pointLight[i].i_location >= numLocations)
+			return false;
+	return true;
+}
+
+// Read color by name or index
+static bool fSceneParseColor(kstr const name, ijkConsoleColor* const color_out)
+{
+	ui32 i;
+	i32 read;
+	for (i = 0; i < 16; ++i)
+		if (!strcmp(name, sceneColorName[i]))
+			break;
+	if (i == 16 && (sscanf(name, "%u%n", &i, &read) != 1 || name[read] || i >= 16))
+		return false;
+	*color_out = (ijkConsoleColor)i;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+
+bool fSceneCreate(sScene* const scene, ui32 const numSpheres, ui32 const numCylinders, ui32 const numPointLights)
+{
+	if (!scene)
+		return false;
+
+	size_t const numLocations = (size_t)numSpheres + (size_t)numCylinders * 2 + (size_t)numPointLights;
+	size_t const numShapes = (size_t)numSpheres + (size_t)numCylinders;
+	ui64 const size = fSceneLayoutSize(numSpheres, numCylinders, numPointLights);
+	byte* const data = (size_t)size == size ? (byte*)malloc(size ? (size_t)size : 1) : 0;
+	ui32 count_object, count_location = 0, count_radius = 0, count_color = 0;
+	if (!data)
+		return false;
+	memset(&scene->map, 0, sizeof(scene->map));
+	fSceneLayout(scene, data, numSpheres, numCylinders, numPointLights);
+
+	// link objects
+	for (count_object = 0; count_object < numSpheres; ++count_object)
+	{
+		scene->sphere[count_object].i_location = count_location++;
+		scene->sphere[count_object].i_radius = count_radius++;
+		scene->sphere[count_object].i_color = count_color++;
+	}
+	for (count_object = 0; count_object < numCylinders; ++count_object)
+	{
+		scene->cylinder[count_object].i_location_cap0 = count_location++;
+		scene->cylinder[count_object].i_location_cap1 = count_location++;
+		scene->cylinder[count_object].i_radius = count_radius++;
+		scene->cylinder[count_object].i_color = count_color++;
+	}
+	for (count_object = 0; count_object < numPointLights; ++count_object)
+	{
+		scene->pointLight[count_object].i_location = count_location++;
+	}
+	ijk_assert(count_location == numLocations);
+	ijk_assert(count_radius == numShapes);
+	ijk_assert(count_color == numShapes);
+	return true;
+}
+
+bool fSceneRelease(sScene* const scene)
+{
+	if (!scene)
+		return false;
+
+	if (scene->map.data)
+		ijkMapRelease(&scene->map);
+	else
+		free(scene->data);
+	memset(scene, 0, sizeof(*scene));
+	return true;
+}
+
+bool fSceneCopy(sScene* const scene_out, sScene const* const scene)
+{
+	if (!scene_out || !scene || !scene_out->data || !scene->data || scene_out->map.data || scene_out->size != scene->size ||
+		scene_out->numSpheres != scene->numSpheres || scene_out->numCylinders != scene->numCylinders ||
+		scene_out->numPointLights != scene->numPointLights)
+		return false;
+
+	memcpy(scene_out->data, scene->data, scene->size);
+	scene_out->color_bg = scene->color_bg;
+	return true;
+}
+
 
 //-----------------------------------------------------------------------------
 
-void fSphereInit(sScene* const scene, ui16 const shapeIndex, float_t const x, float_t const y, float_t const z, float_t const radius, ijkConsoleColor const color_base)
+void fSphereInit(sScene* const scene, ui32 const shapeIndex, float_t const x, float_t const y, float_t const z, float_t const radius, ijkConsoleColor const color_base)
 {
-	ijk_assert(shapeIndex < scene_numSpheres);
+	ijk_assert(shapeIndex < scene->numSpheres);
 
 	sSphere* const sphere = scene->sphere + shapeIndex;
 	vec3fInit(scene->location[sphere->i_location].v, x, y, z);
@@ -39,9 +194,9 @@ void fSphereInit(sScene* const scene, ui16 const shapeIndex, float_t const x, fl
 	scene->color[sphere->i_color].color[1] = color_base | ijkConsoleColor_a;
 }
 
-void fCylinderInit(sScene* const scene, ui16 const shapeIndex, float_t const x0, float_t const y0, float_t const z0, float_t const x1, float_t const y1, float_t const z1, float_t const radius, ijkConsoleColor const color_base)
+void fCylinderInit(sScene* const scene, ui32 const shapeIndex, float_t const x0, float_t const y0, float_t const z0, float_t const x1, float_t const y1, float_t const z1, float_t const radius, ijkConsoleColor const color_base)
 {
-	ijk_assert(shapeIndex < scene_numCylinders);
+	ijk_assert(shapeIndex < scene->numCylinders);
 
 	sCylinder* const cylinder = scene->cylinder + shapeIndex;
 	vec3fInit(scene->location[cylinder->i_location_cap0].v, x0, y0, z0);
@@ -51,34 +206,34 @@ void fCylinderInit(sScene* const scene, ui16 const shapeIndex, float_t const x0,
 	scene->color[cylinder->i_color].color[1] = color_base | ijkConsoleColor_a;
 }
 
-void fPointLightInit(sScene* const scene, ui16 const shapeIndex, float_t const x, float_t const y, float_t const z)
+void fPointLightInit(sScene* const scene, ui32 const shapeIndex, float_t const x, float_t const y, float_t const z)
 {
-	ijk_assert(shapeIndex < scene_numPointLights);
+	ijk_assert(shapeIndex < scene->numPointLights);
 
 	sPointLight* const pointLight = scene->pointLight + shapeIndex;
 	vec3fInit(scene->location[pointLight->i_location].v, x, y, z);
 }
 
-void fSphereGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const location_out, float_t* const radius_out)
+void fSphereGet(sScene const* const scene, ui32 const shapeIndex, vec3f* const location_out, float_t* const radius_out)
 {
-	ijk_assert(shapeIndex < scene_numSpheres);
+	ijk_assert(shapeIndex < scene->numSpheres);
 
 	sSphere const* const sphere = scene->sphere + shapeIndex;
 	*location_out = scene->location[sphere->i_location];
 	*radius_out = scene->radius[sphere->i_radius];
 }
 
-void fSphereGetColor(sScene const* const scene, ui16 const shapeIndex, sColor* const color_out)
+void fSphereGetColor(sScene const* const scene, ui32 const shapeIndex, sColor* const color_out)
 {
-	ijk_assert(shapeIndex < scene_numSpheres);
+	ijk_assert(shapeIndex < scene->numSpheres);
 
 	sSphere const* const sphere = scene->sphere + shapeIndex;
 	*color_out = scene->color[sphere->i_color];
 }
 
-void fCylinderGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const location_cap0_out, vec3f* const location_cap1_out, float_t* const radius_out)
+void fCylinderGet(sScene const* const scene, ui32 const shapeIndex, vec3f* const location_cap0_out, vec3f* const location_cap1_out, float_t* const radius_out)
 {
-	ijk_assert(shapeIndex < scene_numCylinders);
+	ijk_assert(shapeIndex < scene->numCylinders);
 
 	sCylinder const* const cylinder = scene->cylinder + shapeIndex;
 	*location_cap0_out = scene->location[cylinder->i_location_cap0];
@@ -86,46 +241,26 @@ void fCylinderGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const
 	*radius_out = scene->radius[cylinder->i_radius];
 }
 
-void fCylinderGetColor(sScene const* const scene, ui16 const shapeIndex, sColor* const color_out)
+void fCylinderGetColor(sScene const* const scene, ui32 const shapeIndex, sColor* const color_out)
 {
-	ijk_assert(shapeIndex < scene_numCylinders);
+	ijk_assert(shapeIndex < scene->numCylinders);
 
 	sCylinder const* const cylinder = scene->cylinder + shapeIndex;
 	*color_out = scene->color[cylinder->i_color];
 }
 
-void fPointLightGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const location_out)
+void fPointLightGet(sScene const* const scene, ui32 const shapeIndex, vec3f* const location_out)
 {
-	ijk_assert(shapeIndex < scene_numPointLights);
+	ijk_assert(shapeIndex < scene->numPointLights);
 
 	sPointLight const* const pointLight = scene->pointLight + shapeIndex;
 	*location_out = scene->location[pointLight->i_location];
 }
 
-void fSceneInit(sScene* const scene)
+bool fSceneInit(sScene* const scene)
 {
-	// link objects
-	ui16 count_object, count_location = 0, count_radius = 0, count_color = 0;
-	for (count_object = 0; count_object < scene_numSpheres; ++count_object)
-	{
-		scene->sphere[count_object].i_location = count_location++;
-		scene->sphere[count_object].i_radius = count_radius++;
-		scene->sphere[count_object].i_color = count_color++;
-	}
-	for (count_object = 0; count_object < scene_numCylinders; ++count_object)
-	{
-		scene->cylinder[count_object].i_location_cap0 = count_location++;
-		scene->cylinder[count_object].i_location_cap1 = count_location++;
-		scene->cylinder[count_object].i_radius = count_radius++;
-		scene->cylinder[count_object].i_color = count_color++;
-	}
-	for (count_object = 0; count_object < scene_numPointLights; ++count_object)
-	{
-		scene->pointLight[count_object].i_location = count_location++;
-	}
-	ijk_assert(count_location == ijk_arrlen(scene->location));
-	ijk_assert(count_radius == ijk_arrlen(scene->radius));
-	ijk_assert(count_color == ijk_arrlen(scene->color));
+	if (!fSceneCreate(scene, 2, 2, 1))
+		return false;
 
 	// assign values
 	fSphereInit(scene, 0,  0.0f,  0.0f, -9.0f, 2.0f, ijkConsoleColor_red);
@@ -138,6 +273,297 @@ void fSceneInit(sScene* const scene)
 
 	// assign background
 	scene->color_bg = ijkConsoleColor_grey_d;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// Nearest and furthest distance of generated shapes from viewer
+#define scene_distNear	4.0f
+#define scene_distFar	24.0f
+
+// Spread of shapes about a cluster center in normalized view coordinates
+#define scene_spreadBlob	0.25f
+
+// Scramble seed into generator state, so that nearby seeds diverge at 
+//	once; state is never zero
+static ui32 fSceneRandomSeed(ui32 const seed)
+{
+	ui32 x = (seed * 0x9e3779b9u) ^ 0x6a09e667u;
+	x = (x ^ (x >> 16)) * 0x85ebca6bu;
+	return ((x ^ (x >> 13)) | 1u);
+}
+
+// Next pseudo-random number from generator state (xorshift)
+static ui32 fSceneRandom(ui32* const state)
+{
+	ui32 x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return (*state = x);
+}
+
+// Pseudo-random number in [0, 1)
+static float_t fSceneRandomUnit(ui32* const state)
+{
+	return ((float_t)(fSceneRandom(state) >> 8) * (1.0f / 16777216.0f));
+}
+
+// Pseudo-random number in [-1, 1), bell-shaped if requested
+static float_t fSceneRandomSigned(ui32* const state, bool const bell)
+{
+	if (bell)
+		return ((fSceneRandomUnit(state) + fSceneRandomUnit(state) + fSceneRandomUnit(state)) * (2.0f / 3.0f) - 1.0f);
+	return (fSceneRandomUnit(state) * 2.0f - 1.0f);
+}
+
+// Pick location in normalized view coordinates for layout
+static void fSceneRandomPlace(ui32* const state, float3_t coord_out, float3_t const center, float_t const spread)
+{
+	ui32 i;
+	for (i = 0; i < 3; ++i)
+	{
+		coord_out[i] = center[i] + spread * fSceneRandomSigned(state, spread < 1.0f);
+		coord_out[i] = ijk_maximum(-1.0f, ijk_minimum(coord_out[i], 1.0f));
+	}
+}
+
+bool fSceneGenerate(sScene* const scene, sSceneDesc const* const desc)
+{
+	extern f64 pow(f64, f64);
+	ijkConsoleColor const palette[] = { ijkConsoleColor_red, ijkConsoleColor_green, ijkConsoleColor_blue, ijkConsoleColor_yellow, ijkConsoleColor_cyan, ijkConsoleColor_magenta };
+	float3_t coord, center, axis;
+	vec3f location;
+	float_t spread, radius, dist;
+	ui32 i, clusters, state;
+
+	if (!desc || desc->layout >= scene_layoutCount || desc->coverage <= 0.0f || desc->overlap <= 0.0f ||
+		desc->viewSlopeX <= 0.0f || desc->viewSlopeY <= 0.0f || !fSceneCreate(scene, desc->numSpheres, desc->numCylinders, 1))
+		return false;
+
+	state = fSceneRandomSeed(desc->seed);
+
+	// clusters and their spread in normalized view coordinates; 
+	//	uniform is one cluster spanning the whole view
+	ui32 const shapes = desc->numSpheres + desc->numCylinders;
+	switch (desc->layout)
+	{
+	case scene_clustered:
+		clusters = ijk_maximum((ui32)pow((f64)shapes, 1.0 / 3.0), 1);
+		spread = 0.5f / (float_t)pow((f64)clusters, 1.0 / 3.0);
+		break;
+	case scene_blob:
+		clusters = 1;
+		spread = scene_spreadBlob;
+		break;
+	default:
+		clusters = 1;
+		spread = 1.0f;
+		break;
+	}
+
+	// base radius from mean spacing of shapes in the volume they occupy
+	f32 const distMid = (scene_distNear + scene_distFar) * 0.5f, distHalf = (scene_distFar - scene_distNear) * 0.5f;
+	f32 const scaleX = desc->coverage * desc->viewSlopeX * distMid, scaleY = desc->coverage * desc->viewSlopeY * distMid;
+	f64 const volume = (f64)clusters * (f64)(8.0f * spread * spread * spread * scaleX * scaleY * distHalf);
+	f32 const radiusBase = desc->overlap * 0.5f * (f32)pow(volume / (f64)ijk_maximum(shapes, 1), 1.0 / 3.0);
+
+	// place shapes: each picks a cluster, then a location about it
+	vec3fZero(center);
+	for (i = 0; i < shapes; ++i)
+	{
+		if (desc->layout == scene_clustered)
+		{
+			// cluster center depends only on seed and cluster
+			ui32 cluster_state = fSceneRandomSeed(desc->seed ^ fSceneRandomSeed(fSceneRandom(&state) % clusters));
+			center[0] = fSceneRandomSigned(&cluster_state, false) * (1.0f - spread);
+			center[1] = fSceneRandomSigned(&cluster_state, false) * (1.0f - spread);
+			center[2] = fSceneRandomSigned(&cluster_state, false) * (1.0f - spread);
+		}
+		fSceneRandomPlace(&state, coord, center, spread);
+		dist = distMid + coord[2] * distHalf;
+		vec3fInit(location.v, coord[0] * desc->coverage * desc->viewSlopeX * dist, coord[1] * desc->coverage * desc->viewSlopeY * dist, -dist);
+		radius = radiusBase * (0.5f + fSceneRandomUnit(&state));
+		ijkConsoleColor const color = palette[fSceneRandom(&state) % ijk_arrlen(palette)];
+		if (i < desc->numSpheres)
+			fSphereInit(scene, i, location.x, location.y, location.z, radius, color);
+		else
+		{
+			// cylinder: random axis through location, twice as long as it is wide
+			vec3fInit(axis, fSceneRandomSigned(&state, false), fSceneRandomSigned(&state, false), fSceneRandomSigned(&state, false));
+			vec3fMul(axis, axis, radius * vec3fLenInv(axis));
+			fCylinderInit(scene, i - desc->numSpheres, location.x - axis[0], location.y - axis[1], location.z - axis[2],
+				location.x + axis[0], location.y + axis[1], location.z + axis[2], radius * 0.5f, color);
+		}
+	}
+
+	fPointLightInit(scene, 0, +5.0f, +4.0f, -1.0f);
+	scene->color_bg = ijkConsoleColor_grey_d;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+
+ui64 fSceneChecksum(sScene const* const scene)
+{
+	ui32 const* word = (ui32 const*)scene->data;
+	ui32 const* const end = word + scene->size / sizeof(*word);
+	ui32 sum = 0, sumOfSums = 0;
+	for (; word < end; ++word)
+	{
+		sum += *word;
+		sumOfSums += sum;
+	}
+	return ((ui64)sumOfSums << 32 | (ui64)sum);
+}
+
+bool fSceneParse(sScene* const scene, kstr const path, ui32* const line_out_opt)
+{
+	FILE* const file = (scene && path) ? fopen(path, "r") : 0;
+	char text[256], word[32], name[32], * comment;
+	ui32 count[3] = { 0 }, pass, line = 0;
+	float_t v[7];
+	ijkConsoleColor color;
+	bool parsed = true;
+	i32 read;
+
+	if (line_out_opt)
+		*line_out_opt = 0;
+	if (!file)
+		return false;
+
+	// first pass counts items, second creates scene and fills it in
+	for (pass = 0; pass < 2 && parsed; ++pass)
+	{
+		if (pass)
+		{
+			if (!count[2] || !fSceneCreate(scene, count[0], count[1], count[2]))
+			{
+				parsed = false;
+				line = 0;
+				break;
+			}
+			rewind(file);
+			count[0] = count[1] = count[2] = 0;
+			line = 0;
+		}
+		while (parsed && fgets(text, sizeof(text), file))
+		{
+			++line;
+			comment = strchr(text, '#');
+			if (comment)
+				*comment = 0;
+			if (sscanf(text, "%31s%n", word, &read) != 1)
+				continue;
+			if (!strcmp(word, "sphere"))
+			{
+				parsed = sscanf(text + read, "%f %f %f %f %31s", v, v + 1, v + 2, v + 3, name) == 5 && v[3] > 0.0f && fSceneParseColor(name, &color);
+				if (parsed && pass)
+					fSphereInit(scene, count[0], v[0], v[1], v[2], v[3], color);
+				++count[0];
+			}
+			else if (!strcmp(word, "cylinder"))
+			{
+				parsed = sscanf(text + read, "%f %f %f %f %f %f %f %31s", v, v + 1, v + 2, v + 3, v + 4, v + 5, v + 6, name) == 8 && v[6] > 0.0f && fSceneParseColor(name, &color);
+				if (parsed && pass)
+					fCylinderInit(scene, count[1], v[0], v[1], v[2], v[3], v[4], v[5], v[6], color);
+				++count[1];
+			}
+			else if (!strcmp(word, "light"))
+			{
+				parsed = sscanf(text + read, "%f %f %f", v, v + 1, v + 2) == 3;
+				if (parsed && pass)
+					fPointLightInit(scene, count[2], v[0], v[1], v[2]);
+				++count[2];
+			}
+			else if (!strcmp(word, "background"))
+			{
+				parsed = sscanf(text + read, "%31s", name) == 1 && fSceneParseColor(name, &color);
+				if (parsed && pass)
+					scene->color_bg = color;
+			}
+			else
+				parsed = false;
+		}
+	}
+	fclose(file);
+	if (!parsed)
+	{
+		if (pass > 1)
+			fSceneRelease(scene);
+		if (line_out_opt)
+			*line_out_opt = line;
+	}
+	return parsed;
+}
+
+bool fSceneSave(sScene const* const scene, kstr const path)
+{
+	sSceneFile header = { scene_fileMagic, scene_fileVersion };
+	byte const pad[scene_fileAlign] = { 0 };
+	FILE* file;
+	bool saved;
+	if (!scene || !scene->data || !path || !*path)
+		return false;
+
+	header.numSpheres = scene->numSpheres;
+	header.numCylinders = scene->numCylinders;
+	header.numPointLights = scene->numPointLights;
+	header.color_bg = (ui32)scene->color_bg;
+	header.size_sphere = (ui16)sizeof(*scene->sphere);
+	header.size_cylinder = (ui16)sizeof(*scene->cylinder);
+	header.size_pointLight = (ui16)sizeof(*scene->pointLight);
+	header.size_location = (ui16)sizeof(*scene->location);
+	header.size_radius = (ui16)sizeof(*scene->radius);
+	header.size_color = (ui16)sizeof(*scene->color);
+	header.offset = (sizeof(header) + scene_fileAlign - 1) / scene_fileAlign * scene_fileAlign;
+	header.size = scene->size;
+	header.checksum = fSceneChecksum(scene);
+
+	file = fopen(path, "wb");
+	if (!file)
+		return false;
+	saved = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(pad, 1, (size_t)header.offset - sizeof(header), file) == (size_t)header.offset - sizeof(header)
+		&& fwrite(scene->data, 1, scene->size, file) == scene->size;
+	saved = (fclose(file) == 0) && saved;
+	return saved;
+}
+
+bool fSceneLoad(sScene* const scene, kstr const path)
+{
+	sScene loaded = { 0 };
+	sSceneFile header = { 0 };
+	if (!scene || !path || !*path || !ijk_issuccess(ijkMapOpen(&loaded.map, path, false)))
+		return false;
+
+	// the block is only used in place if the file was written for this 
+	//	layout and is intact
+	if (loaded.map.size >= sizeof(header))
+		memcpy(&header, loaded.map.data, sizeof(header));
+	if (header.magic != scene_fileMagic || header.version != scene_fileVersion || !header.numPointLights
+		|| header.size_sphere != sizeof(*loaded.sphere) || header.size_cylinder != sizeof(*loaded.cylinder)
+		|| header.size_pointLight != sizeof(*loaded.pointLight) || header.size_location != sizeof(*loaded.location)
+		|| header.size_radius != sizeof(*loaded.radius) || header.size_color != sizeof(*loaded.color)
+		|| header.offset < sizeof(header) || header.offset % scene_fileAlign || header.offset > loaded.map.size
+		|| header.size > loaded.map.size - header.offset
+		|| header.size != fSceneLayoutSize(header.numSpheres, header.numCylinders, header.numPointLights))
+	{
+		ijkMapRelease(&loaded.map);
+		return false;
+	}
+	fSceneLayout(&loaded, loaded.map.data + header.offset, header.numSpheres, header.numCylinders, header.numPointLights);
+	loaded.color_bg = (ijkConsoleColor)header.color_bg;
+	if (fSceneChecksum(&loaded) != header.checksum || !fSceneCheckLinks(&loaded))
+	{
+		ijkMapRelease(&loaded.map);
+		return false;
+	}
+	*scene = loaded;
+	return true;
 }
 
 
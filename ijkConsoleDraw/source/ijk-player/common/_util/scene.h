@@ -28,6 +28,7 @@
 
 #include "vec3f.h"
 #include "ijkConsole.h"
+#include "ijkMap.h"
 
 
 #ifdef __cplusplus
@@ -42,31 +43,27 @@ typedef enum eShape_t
 {
 	shape_sphere,
 	shape_cylinder,
+	shape_none,		// No shape (e.g. ray missed everything)
 } eShape;
 
 // Describe sphere in list
 typedef struct sSphere_t
 {
-	ui16 i_location, i_radius, i_color;
+	ui32 i_location, i_radius, i_color;
 } sSphere;
 
 // Describe cylinder in list
 typedef struct sCylinder_t
 {
-	ui16 i_location_cap0, i_location_cap1, i_radius, i_color;
+	ui32 i_location_cap0, i_location_cap1, i_radius, i_color;
 } sCylinder;
 
 // Describe point light in main list
 typedef struct sPointLight_t
 {
-	ui16 i_location;
+	ui32 i_location;
 } sPointLight;
 
-#define scene_numSpheres		2
-#define scene_numCylinders		2
-#define scene_numPointLights	1
-#define scene_numObjects		scene_numSpheres + scene_numCylinders + scene_numPointLights
-
 // Cnsole color ramp
 typedef struct sColor_t
 {
@@ -74,38 +71,118 @@ typedef struct sColor_t
 } sColor;
 
 // Main scene
+//	-> NOTE: every list lives in one allocation ('data'), in the order 
+//		they are declared, so a scene is copied with a single block copy
+//	-> a scene loaded from a binary scene file points into the mapped 
+//		file instead ('map'), and is read-only
 typedef struct sScene_t
 {
-	sSphere sphere[scene_numSpheres];
-	sCylinder cylinder[scene_numCylinders];
-	sPointLight pointLight[scene_numPointLights];
+	ui32 numSpheres, numCylinders, numPointLights;
+
+	sSphere* sphere;
+	sCylinder* cylinder;
+	sPointLight* pointLight;
 
-	vec3f location[scene_numObjects + scene_numCylinders];
-	float_t radius[scene_numSpheres + scene_numCylinders];
-	sColor color[scene_numSpheres + scene_numCylinders];
+	vec3f* location;
+	float_t* radius;
+	sColor* color;
 
 	ijkConsoleColor color_bg;
+
+	ptr data;
+	size_t size;
+	ijkMap map;
 } sScene;
 
+// Binary scene file tag ("ijSC" in memory) and layout version
+#define scene_fileMagic		0x43536a69
+#define scene_fileVersion	1
 
+// Binary scene file header; the scene block follows at 'offset', byte for 
+//	byte as laid out in memory, so loading maps it without parsing
+//	-> element sizes are stored so a build with another layout refuses the 
+//		file rather than misreading it; values are in host byte order
+typedef struct sSceneFile_t
+{
+	ui32 magic, version;		// Tag and layout version
+	ui32 numSpheres, numCylinders, numPointLights;
+	ui32 color_bg;				// Background color
+	ui16 size_sphere, size_cylinder, size_pointLight, size_location, size_radius, size_color;
+	ui32 reserved;				// Alignment of 64-bit members
+	ui64 offset;				// Offset of scene block in file (aligned to a cache line)
+	ui64 size;					// Bytes of scene block
+	ui64 checksum;				// Checksum of scene block (see fSceneChecksum)
+} sSceneFile;
+
+// Spatial distributions of generated shapes
+typedef enum eSceneLayout_t
+{
+	scene_uniform,				// Spread evenly through the view
+	scene_clustered,			// Gathered in clusters spread through the view
+	scene_blob,					// Gathered in a single dense cluster in the middle
+	scene_layoutCount
+} eSceneLayout;
+
+// Description of generated scene
+//	-> shapes are placed in normalized view coordinates, scaled by the 
+//		view's half extents per unit of distance, so coverage is the 
+//		fraction of the view the layout spans on each axis
+//	-> overlap scales shape size against the mean spacing of shapes in 
+//		the volume they occupy: below one they tend to stand apart, above 
+//		one they tend to intersect
+typedef struct sSceneDesc_t
+{
+	ui32 seed;					// Seed; the same description gives the same scene
+	ui32 numSpheres, numCylinders;	// Number of each shape
+	eSceneLayout layout;		// Spatial distribution of shapes
+	f32 coverage;				// Fraction of view spanned by layout (0, 1]
+	f32 overlap;				// Size of shapes relative to their spacing
+	f32 viewSlopeX, viewSlopeY;	// Half extents of view per unit of distance
+} sSceneDesc;
+
+
+// Allocate and link scene lists; values are left uninitialized
+bool fSceneCreate(sScene* const scene, ui32 const numSpheres, ui32 const numCylinders, ui32 const numPointLights);
+// Release scene lists
+bool fSceneRelease(sScene* const scene);
+// Copy values of scene into another with the same number of each shape
+bool fSceneCopy(sScene* const scene_out, sScene const* const scene);
 // Initialize sphere shape descriptor
-void fSphereInit(sScene* const scene, ui16 const shapeIndex, float_t const x, float_t const y, float_t const z, float_t const radius, ijkConsoleColor const color_base);
+void fSphereInit(sScene* const scene, ui32 const shapeIndex, float_t const x, float_t const y, float_t const z, float_t const radius, ijkConsoleColor const color_base);
 // Initialize cylinder shape descriptor
-void fCylinderInit(sScene* const scene, ui16 const shapeIndex, float_t const x0, float_t const y0, float_t const z0, float_t const x1, float_t const y1, float_t const z1, float_t const radius, ijkConsoleColor const color_base);
+void fCylinderInit(sScene* const scene, ui32 const shapeIndex, float_t const x0, float_t const y0, float_t const z0, float_t const x1, float_t const y1, float_t const z1, float_t const radius, ijkConsoleColor const color_base);
 // Initialize point light shape descriptor
-void fPointLightInit(sScene* const scene, ui16 const shapeIndex, float_t const x, float_t const y, float_t const z);
+void fPointLightInit(sScene* const scene, ui32 const shapeIndex, float_t const x, float_t const y, float_t const z);
 // Get sphere shape info
-void fSphereGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const location_out, float_t* const radius_out);
+void fSphereGet(sScene const* const scene, ui32 const shapeIndex, vec3f* const location_out, float_t* const radius_out);
 // Get sphere color ramp
-void fSphereGetColor(sScene const* const scene, ui16 const shapeIndex, sColor* const color_out);
+void fSphereGetColor(sScene const* const scene, ui32 const shapeIndex, sColor* const color_out);
 // Get cylinder shape info
-void fCylinderGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const location_cap0_out, vec3f* const location_cap1_out, float_t* const radius_out);
+void fCylinderGet(sScene const* const scene, ui32 const shapeIndex, vec3f* const location_cap0_out, vec3f* const location_cap1_out, float_t* const radius_out);
 // Get cylinder color ramp
-void fCylinderGetColor(sScene const* const scene, ui16 const shapeIndex, sColor* const color_out);
+void fCylinderGetColor(sScene const* const scene, ui32 const shapeIndex, sColor* const color_out);
 // Get point light shape info
-void fPointLightGet(sScene const* const scene, ui16 const shapeIndex, vec3f* const location_out);
-// Initialize scene
-void fSceneInit(sScene* const scene);
+void fPointLightGet(sScene const* const scene, ui32 const shapeIndex, vec3f* const location_out);
+// Create and initialize default scene
+bool fSceneInit(sScene* const scene);
+// Create and initialize generated scene from description
+bool fSceneGenerate(sScene* const scene, sSceneDesc const* const desc);
+// Checksum of scene block (sums of 32-bit words, as in Fletcher's)
+ui64 fSceneChecksum(sScene const* const scene);
+// Create scene from text description, stopping at first bad line (stored 
+//	if requested; zero if the file could not be read or has no light)
+//	-> one item per line, '#' starts a comment; colors are names as in 
+//		ijkConsoleColor ("red", "blue_d", ...) or indices 0-15:
+//		"background color"
+//		"sphere x y z radius color"
+//		"cylinder x0 y0 z0 x1 y1 z1 radius color"
+//		"light x y z" (at least one; shading uses the first)
+bool fSceneParse(sScene* const scene, kstr const path, ui32* const line_out_opt);
+// Write scene as binary scene file
+bool fSceneSave(sScene const* const scene, kstr const path);
+// Load binary scene file by mapping it; lists point into the file, which 
+//	is only read to verify its checksum and that every link is in range
+bool fSceneLoad(sScene* const scene, kstr const path);
 
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,218 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	shape.inl
+	Ray tests and surface shading shared by the renderer (C) and the
+		specialized kernels (C++), so both trace with the same math.
+*/
+
+#ifndef _SHAPE_INL_
+#define _SHAPE_INL_
+
+#include "scene.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// Nearest ray parameter considered a hit (avoids self-intersection)
+#define ray_distMin 0.001f
+
+// Lambertian coefficient above which the light color of the ramp is used
+#define shade_lambertLight 0.5f
+
+// Reference to shape in scene
+//	-> 'dist' is the nearest the shape can be to the viewer when listed
+//		front to back, zero otherwise
+typedef struct sShapeRef_t
+{
+	ui32 type, index;
+	float_t dist;
+} sShapeRef;
+
+
+//-----------------------------------------------------------------------------
+
+// Solve ray against sphere for nearest ray parameter at or past minimum
+ijk_inl bool fShapeSolveSphere(sScene const* const scene, ui32 const shapeIndex, float3_t const origin, float3_t const direction, float_t* const dist_out)
+{
+	vec3f location;
+	float_t radius;
+	fSphereGet(scene, shapeIndex, &location, &radius);
+
+	// solve |origin + direction * t - location| = radius for t,
+	//	using the half-b form of the quadratic: a*t^2 + 2*b*t + c = 0
+	vec3f diff;
+	vec3fSub(diff.v, origin, location.v);
+	float_t const a = vec3fLenSq(direction);
+	float_t const b = vec3fDot(direction, diff.v);
+	float_t const c = vec3fLenSq(diff.v) - radius * radius;
+	float_t const disc = b * b - a * c;
+	if (disc < 0.0f || !fIsNonZero(a))
+		return false;
+
+	// take near root, or far root if origin is inside
+	float_t const root = fSqrt(disc), aInv = 1.0f / a;
+	float_t dist = (-b - root) * aInv;
+	if (dist < ray_distMin)
+	{
+		dist = (-b + root) * aInv;
+		if (dist < ray_distMin)
+			return false;
+	}
+	*dist_out = dist;
+	return true;
+}
+
+// Solve ray against finite cylinder for nearest ray parameter at or past minimum
+ijk_inl bool fShapeSolveCylinder(sScene const* const scene, ui32 const shapeIndex, float3_t const origin, float3_t const direction, float_t* const dist_out)
+{
+	vec3f location_cap0;
+	vec3f location_cap1;
+	float_t radius;
+	fCylinderGet(scene, shapeIndex, &location_cap0, &location_cap1, &radius);
+
+	// axis frame: unit axis and length, ray in terms of axis
+	vec3f axis, diff;
+	vec3fSub(axis.v, location_cap1.v, location_cap0.v);
+	float_t const len = vec3fLen(axis.v);
+	if (!fIsNonZero(len))
+		return false;
+	vec3fMul(axis.v, axis.v, 1.0f / len);
+	vec3fSub(diff.v, origin, location_cap0.v);
+	float_t const d_axis = vec3fDot(direction, axis.v);
+	float_t const o_axis = vec3fDot(diff.v, axis.v);
+	float_t const rSq = radius * radius;
+	float_t dist = -1.0f, s, t;
+
+	// side: solve for components perpendicular to axis (half-b form),
+	//	then keep roots whose axial coordinate lands between caps
+	vec3f d_perp, o_perp;
+	vec3fMad(d_perp.v, direction, axis.v, -d_axis);
+	vec3fMad(o_perp.v, diff.v, axis.v, -o_axis);
+	float_t const a = vec3fLenSq(d_perp.v);
+	if (fIsNonZero(a))
+	{
+		float_t const b = vec3fDot(d_perp.v, o_perp.v);
+		float_t const c = vec3fLenSq(o_perp.v) - rSq;
+		float_t const disc = b * b - a * c;
+		if (disc >= 0.0f)
+		{
+			float_t const root = fSqrt(disc), aInv = 1.0f / a;
+			t = (-b - root) * aInv;
+			s = o_axis + d_axis * t;
+			if (t >= ray_distMin && s >= 0.0f && s <= len)
+				dist = t;
+			else
+			{
+				t = (-b + root) * aInv;
+				s = o_axis + d_axis * t;
+				if (t >= ray_distMin && s >= 0.0f && s <= len)
+					dist = t;
+			}
+		}
+	}
+
+	// caps: intersect planes at either end, keep if within radius
+	if (fIsNonZero(d_axis))
+	{
+		float_t const dInv = 1.0f / d_axis;
+		vec3f p;
+		ui16 cap;
+		for (cap = 0; cap < 2; ++cap)
+		{
+			t = ((cap ? len : 0.0f) - o_axis) * dInv;
+			if (t >= ray_distMin && (dist < 0.0f || t < dist))
+			{
+				vec3fMad(p.v, o_perp.v, d_perp.v, t);
+				if (vec3fLenSq(p.v) <= rSq)
+					dist = t;
+			}
+		}
+	}
+
+	if (dist < 0.0f)
+		return false;
+	*dist_out = dist;
+	return true;
+}
+
+// Calculate unit surface normal of shape at point on it
+//	-> normals only feed shading, so they are scaled with the fast tier
+ijk_inl bool fShapeGetNormal(sScene const* const scene, ui32 const shapeType, ui32 const shapeIndex, float3_t const point, float3_t normal_out)
+{
+	vec3f location, location_cap1, axis, diff;
+	float_t radius, len, s, rho, dCap0, dCap1, dSide;
+
+	switch (shapeType)
+	{
+	case shape_sphere:
+		fSphereGet(scene, shapeIndex, &location, &radius);
+		vec3fSub(normal_out, point, location.v);
+		vec3fMul(normal_out, normal_out, fRecipFast(radius));
+		return true;
+	case shape_cylinder:
+		fCylinderGet(scene, shapeIndex, &location, &location_cap1, &radius);
+		vec3fSub(axis.v, location_cap1.v, location.v);
+		len = vec3fLen(axis.v);
+		vec3fMul(axis.v, axis.v, fRecip(len));
+		vec3fSub(diff.v, point, location.v);
+		s = vec3fDot(diff.v, axis.v);
+		vec3fMad(diff.v, diff.v, axis.v, -s);
+		rho = vec3fLen(diff.v);
+
+		// normal of whichever surface (cap or side) the point is closest to
+		dCap0 = s;
+		dCap1 = len - s;
+		dSide = rho > radius ? rho - radius : radius - rho;
+		if (dCap0 <= dCap1 && dCap0 < dSide)
+			vec3fNegate(normal_out, axis.v);
+		else if (dCap1 < dSide)
+			vec3fCopy(normal_out, axis.v);
+		else
+			vec3fMul(normal_out, diff.v, fRecipFast(rho));
+		return true;
+	}
+	return false;
+}
+
+// Calculate Lambertian coefficient at point with normal from light,
+//	storing direction from point to light (not normalized)
+ijk_inl float_t fShapeCalcLambert(float3_t const point, float3_t const normal, float3_t const light, float3_t toLight_out)
+{
+	vec3fSub(toLight_out, light, point);
+	return (vec3fDot(normal, toLight_out) * vec3fLenInvFast(toLight_out));
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_SHAPE_INL_
\ No newline at end of file
@@ -31,4 +31,76 @@
 vec3f const vec3f0 = { 0.0f, 0.0f, 0.0f };
 
 
+//-----------------------------------------------------------------------------
+
+// Float bit patterns bounding positive normal floats
+#define vec_bitsNormalMin 0x00800000u
+#define vec_bitsNormalMax 0x7f7fffffu
+
+// Get bit pattern of float
+static ui32 fGetBits(float_t const s)
+{
+	union { float_t f; ui32 i; } const bits = { s };
+	return bits.i;
+}
+
+// Get float from bit pattern
+static float_t fFromBits(ui32 const i)
+{
+	union { ui32 i; float_t f; } const bits = { i };
+	return bits.f;
+}
+
+// Get distance between two positive floats in units in the last place
+static ui32 fGetErrorULP(float_t const s, float_t const s_ref)
+{
+	ui32 const i = fGetBits(s), i_ref = fGetBits(s_ref);
+	return (i > i_ref ? i - i_ref : i_ref - i);
+}
+
+// Measure largest error of function against reference over inputs
+//	-> inputs whose reference result is not a positive normal are skipped
+static ui32 fCalcErrorULP(float_t(*const func)(float_t const), float_t(*const func_ref)(float_t const), ui32 const step)
+{
+	ui32 i, error, errorMax = 0;
+	float_t s, result_ref;
+	for (i = vec_bitsNormalMin; i <= vec_bitsNormalMax && i >= vec_bitsNormalMin; i += (step ? step : 1))
+	{
+		s = fFromBits(i);
+		result_ref = func_ref(s);
+		if (fGetBits(result_ref) < vec_bitsNormalMin || fGetBits(result_ref) > vec_bitsNormalMax)
+			continue;
+		error = fGetErrorULP(func(s), result_ref);
+		errorMax = (error > errorMax ? error : errorMax);
+	}
+	return errorMax;
+}
+
+// Precise references for the fast tier
+static float_t fRecipPrecise(float_t const s)
+{
+	return (1.0f / s);
+}
+
+static float_t fSqrtInvPrecise(float_t const s)
+{
+	return (1.0f / fSqrt(s));
+}
+
+ui32 fRecipFastErrorULP(ui32 const step)
+{
+	return fCalcErrorULP(fRecipFast, fRecipPrecise, step);
+}
+
+ui32 fSqrtFastErrorULP(ui32 const step)
+{
+	return fCalcErrorULP(fSqrtFast, fSqrt, step);
+}
+
+ui32 fSqrtInvFastErrorULP(ui32 const step)
+{
+	return fCalcErrorULP(fSqrtInvFast, fSqrtInvPrecise, step);
+}
+
+
 //-----------------------------------------------------------------------------
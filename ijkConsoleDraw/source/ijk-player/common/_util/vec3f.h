@@ -29,6 +29,19 @@
 #include "ijk/ijk/ijk-typedefs.h"
 
 
+// SIMD instruction set used by vector math (scalar if neither is defined)
+//	-> SSE is baseline on x86-64 and enabled by default on x86 with MSVC
+#if (defined _M_X64 || defined __x86_64__ || defined __SSE__ || (defined _M_IX86_FP && _M_IX86_FP >= 1))
+#define vec_simd
+#define vec_simd_sse
+#include <xmmintrin.h>
+#elif (defined _M_ARM64 || defined __aarch64__)
+#define vec_simd
+#define vec_simd_neon
+#include <arm_neon.h>
+#endif	// SIMD
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif	// __cplusplus
@@ -60,7 +73,7 @@ bool fIsZero(float_t const s);
 bool fIsNonZero(float_t const s);
 // Safe reciprocal (1/s)
 float_t fRecip(float_t const s);
-// Square root wrapper
+// Square root wrapper (single precision instruction if available)
 float_t fSqrt(float_t const s);
 // Safe square root reciprocal
 float_t fSqrtInv(float_t const s);
@@ -70,6 +83,31 @@ float_t fLerp(float_t const s0, float_t const s1, float_t const u);
 float_t fMad(float_t const s0, float_t const ds, float_t const u);
 
 
+//-----------------------------------------------------------------------------
+
+// Fast approximate tier: hardware estimate refined by one Newton step
+//	-> no zero checks: inputs must be non-zero (positive for roots)
+//	-> SSE reciprocal estimates flush to zero above about 2^126, so the 
+//		fast reciprocal of such inputs is zero instead of tiny
+//	-> use where a small error is invisible (e.g. shading), keep the 
+//		precise tier where it is not (e.g. intersection)
+
+// Fast reciprocal (1/s)
+float_t fRecipFast(float_t const s);
+// Fast square root
+float_t fSqrtFast(float_t const s);
+// Fast square root reciprocal
+float_t fSqrtInvFast(float_t const s);
+
+// Measure largest error of fast reciprocal against precise, in units in 
+//	the last place, over every 'step'th positive float with a normal result
+ui32 fRecipFastErrorULP(ui32 const step);
+// Measure largest error of fast square root against precise (see above)
+ui32 fSqrtFastErrorULP(ui32 const step);
+// Measure largest error of fast square root reciprocal against precise
+ui32 fSqrtInvFastErrorULP(ui32 const step);
+
+
 //-----------------------------------------------------------------------------
 
 // Constant zero vector
@@ -95,6 +133,8 @@ float_t vec3fLen(float3_t const v);
 float_t vec3fLenSqInv(float3_t const v);
 // Calculate vector length inverse
 float_t vec3fLenInv(float3_t const v);
+// Calculate vector length inverse, fast tier (vector must be non-zero)
+float_t vec3fLenInvFast(float3_t const v);
 // Calculate vector sum
 floatv_t vec3fAdd(float3_t v_out, float3_t const v_lh, float3_t const v_rh);
 // Calculate vector difference
@@ -113,6 +153,8 @@ float_t vec3fProjs(float3_t const v_base, float3_t const v);
 floatv_t vec3fProj(float3_t v_out, float3_t const v_base, float3_t const v);
 // Calculate normalized vector
 floatv_t vec3fUnit(float3_t v_out, float3_t const v);
+// Calculate normalized vector, fast tier (vector must be non-zero)
+floatv_t vec3fUnitFast(float3_t v_out, float3_t const v);
 // Calculate squared distance between two vectors
 float_t vec3fDistSq(float3_t const v_lh, float3_t const v_rh);
 // Calculate distance between two vectors
@@ -52,8 +52,14 @@ ijk_inl float_t fRecip(float_t const s)
 
 ijk_inl float_t fSqrt(float_t const s)
 {
+#if (defined vec_simd_sse)
+	return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(s)));
+#elif (defined vec_simd_neon)
+	return vget_lane_f32(vsqrt_f32(vdup_n_f32(s)), 0);
+#else	// !SIMD
 	extern f64 sqrt(f64);
 	return (float_t)sqrt((f64)s);
+#endif	// SIMD
 }
 
 ijk_inl float_t fSqrtInv(float_t const s)
@@ -72,6 +78,47 @@ ijk_inl float_t fMad(float_t const s0, float_t const ds, float_t const u)
 }
 
 
+//-----------------------------------------------------------------------------
+
+ijk_inl float_t fRecipFast(float_t const s)
+{
+	// y' = y * (2 - s * y)
+#if (defined vec_simd_sse)
+	__m128 const x = _mm_set_ss(s), y = _mm_rcp_ss(x);
+	return _mm_cvtss_f32(_mm_mul_ss(y, _mm_sub_ss(_mm_set_ss(2.0f), _mm_mul_ss(x, y))));
+#elif (defined vec_simd_neon)
+	float32x2_t const x = vdup_n_f32(s), y = vrecpe_f32(x);
+	return vget_lane_f32(vmul_f32(y, vrecps_f32(x, y)), 0);
+#else	// !SIMD
+	return (1.0f / s);
+#endif	// SIMD
+}
+
+ijk_inl float_t fSqrtInvFast(float_t const s)
+{
+	// y' = y * (1.5 - 0.5 * s * y^2)
+#if (defined vec_simd_sse)
+	__m128 const x = _mm_set_ss(s), y = _mm_rsqrt_ss(x);
+	__m128 const h = _mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), x), _mm_mul_ss(y, y));
+	return _mm_cvtss_f32(_mm_mul_ss(y, _mm_sub_ss(_mm_set_ss(1.5f), h)));
+#elif (defined vec_simd_neon)
+	float32x2_t const x = vdup_n_f32(s), y = vrsqrte_f32(x);
+	return vget_lane_f32(vmul_f32(y, vrsqrts_f32(vmul_f32(x, y), y)), 0);
+#else	// !SIMD
+	// estimate from halving the exponent in the bit pattern
+	union { float_t f; ui32 i; } y;
+	y.f = s;
+	y.i = 0x5f375a86 - (y.i >> 1);
+	return y.f * (1.5f - 0.5f * s * y.f * y.f);
+#endif	// SIMD
+}
+
+ijk_inl float_t fSqrtFast(float_t const s)
+{
+	return (s * fSqrtInvFast(s));
+}
+
+
 //-----------------------------------------------------------------------------
 
 ijk_inl floatv_t vec3fZero(float3_t v_out)
@@ -141,6 +188,11 @@ ijk_inl float_t vec3fLenInv(float3_t const v)
 	return (lenSq > epsf ? 1.0f / fSqrt(lenSq) : 0.0f);
 }
 
+ijk_inl float_t vec3fLenInvFast(float3_t const v)
+{
+	return fSqrtInvFast(vec3fLenSq(v));
+}
+
 ijk_inl floatv_t vec3fAdd(float3_t v_out, float3_t const v_lh, float3_t const v_rh)
 {
 	v_out[0] = v_lh[0] + v_rh[0];
@@ -202,6 +254,11 @@ ijk_inl floatv_t vec3fUnit(float3_t v_out, float3_t const v)
 	return vec3fMul(v_out, v, vec3fLenInv(v));
 }
 
+ijk_inl floatv_t vec3fUnitFast(float3_t v_out, float3_t const v)
+{
+	return vec3fMul(v_out, v, vec3fLenInvFast(v));
+}
+
 ijk_inl float_t vec3fDistSq(float3_t const v_lh, float3_t const v_rh)
 {
 	float3_t dv;
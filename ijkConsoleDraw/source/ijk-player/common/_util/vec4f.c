@@ -0,0 +1,34 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	vec4f.c
+	SIMD 4D float vector internal implementation.
+*/
+
+#include "vec4f.h"
+
+
+//-----------------------------------------------------------------------------
+
+vec4f const vec4f0 = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	vec4f.h
+	SIMD 4D float vector and 3D vector stream interface.
+*/
+
+#ifndef _VEC4F_H_
+#define _VEC4F_H_
+
+#include "vec3f.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// Array-based 4D vector type
+typedef float_t float4_t[4];
+
+// 4D float vector structure, aligned for SIMD registers
+//	-> 3D directions and points are stored with 'w' zero so 4-wide dot 
+//		products and lengths match their 3D counterparts
+typedef union vec4f_t
+{
+	// Array representation
+	float4_t v;
+	// Individual vector elements
+	struct { float_t x, y, z, w; };
+#if (defined vec_simd_sse)
+	// Register representation
+	__m128 m;
+#elif (defined vec_simd_neon)
+	// Register representation
+	float32x4_t m;
+#endif	// SIMD
+} vec4f;
+
+// Stream of 3D vectors stored as one array per element
+//	-> structure of arrays: element i of every array makes vector i, so 
+//		streams are processed four vectors at a time
+typedef struct vec3fStream_t
+{
+	// Element arrays
+	floatv_t x, y, z;
+} vec3fStream;
+
+
+//-----------------------------------------------------------------------------
+
+// Constant zero vector
+extern vec4f const vec4f0;
+
+// Make zero vector
+vec4f* vec4fZero(vec4f* const v_out);
+// Initialize vector with individual elements
+vec4f* vec4fInit(vec4f* const v_out, float_t const x, float_t const y, float_t const z, float_t const w);
+// Initialize vector from 3D vector and 'w' element
+vec4f* vec4fInit3(vec4f* const v_out, float3_t const v, float_t const w);
+// Get 3D vector from first three elements
+floatv_t vec4fGet3(float3_t v_out, vec4f const* const v);
+// Negate vector
+vec4f* vec4fNegate(vec4f* const v_out, vec4f const* const v);
+// Calculate vector dot product
+float_t vec4fDot(vec4f const* const v_lh, vec4f const* const v_rh);
+// Calculate 3D cross product of first three elements ('w' is zero)
+vec4f* vec4fCross(vec4f* const v_out, vec4f const* const v_lh, vec4f const* const v_rh);
+// Calculate vector length squared
+float_t vec4fLenSq(vec4f const* const v);
+// Calculate vector length
+float_t vec4fLen(vec4f const* const v);
+// Calculate vector length inverse
+float_t vec4fLenInv(vec4f const* const v);
+// Calculate vector sum
+vec4f* vec4fAdd(vec4f* const v_out, vec4f const* const v_lh, vec4f const* const v_rh);
+// Calculate vector difference
+vec4f* vec4fSub(vec4f* const v_out, vec4f const* const v_lh, vec4f const* const v_rh);
+// Calculate vector multiplied by scalar
+vec4f* vec4fMul(vec4f* const v_out, vec4f const* const v_lh, float_t const s_rh);
+// Calculate vector multiply-add
+vec4f* vec4fMad(vec4f* const v_out, vec4f const* const v0, vec4f const* const dv, float_t const u);
+// Calculate normalized vector
+vec4f* vec4fUnit(vec4f* const v_out, vec4f const* const v);
+
+
+//-----------------------------------------------------------------------------
+
+// Calculate dot product per vector of streams
+floatv_t vec3fStreamDot(floatv_t s_out, vec3fStream const* const v_lh, vec3fStream const* const v_rh, size_t const count);
+// Calculate length squared per vector of stream
+floatv_t vec3fStreamLenSq(floatv_t s_out, vec3fStream const* const v, size_t const count);
+// Calculate multiply-add per vector of streams
+vec3fStream const* vec3fStreamMad(vec3fStream const* const v_out, vec3fStream const* const v0, vec3fStream const* const dv, float_t const u, size_t const count);
+// Calculate normalized vector per vector of stream
+vec3fStream const* vec3fStreamUnit(vec3fStream const* const v_out, vec3fStream const* const v, size_t const count);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#include "vec4f.inl"
+
+
+#endif	// !_VEC4F_H_
\ No newline at end of file
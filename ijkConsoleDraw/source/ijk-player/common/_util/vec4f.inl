@@ -0,0 +1,296 @@
+/*
+   Copyright 2020-2022 Daniel S. Buckstein
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	ijk: an open-source, cross-platform, light-weight,
+		c-based rendering framework
+	By Daniel S. Buckstein
+
+	vec4f.inl
+	SIMD 4D float vector and 3D vector stream implementation.
+*/
+
+#ifdef _VEC4F_H_
+#ifndef _VEC4F_INL_
+#define _VEC4F_INL_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// Register operations per instruction set
+//	-> loads and stores are unaligned so streams can start anywhere
+#if (defined vec_simd_sse)
+typedef __m128 vec4freg_t;
+#define vec4fRegLoad(p)				_mm_loadu_ps(p)
+#define vec4fRegStore(p, r)			_mm_storeu_ps(p, r)
+#define vec4fRegSet(s)				_mm_set1_ps(s)
+#define vec4fRegAdd(r_lh, r_rh)		_mm_add_ps(r_lh, r_rh)
+#define vec4fRegSub(r_lh, r_rh)		_mm_sub_ps(r_lh, r_rh)
+#define vec4fRegMul(r_lh, r_rh)		_mm_mul_ps(r_lh, r_rh)
+#define vec4fRegDiv(r_lh, r_rh)		_mm_div_ps(r_lh, r_rh)
+#define vec4fRegSqrt(r)				_mm_sqrt_ps(r)
+#define vec4fRegSelectGt(r, r_lh, r_rh)	_mm_and_ps(r, _mm_cmpgt_ps(r_lh, r_rh))
+#elif (defined vec_simd_neon)
+typedef float32x4_t vec4freg_t;
+#define vec4fRegLoad(p)				vld1q_f32(p)
+#define vec4fRegStore(p, r)			vst1q_f32(p, r)
+#define vec4fRegSet(s)				vdupq_n_f32(s)
+#define vec4fRegAdd(r_lh, r_rh)		vaddq_f32(r_lh, r_rh)
+#define vec4fRegSub(r_lh, r_rh)		vsubq_f32(r_lh, r_rh)
+#define vec4fRegMul(r_lh, r_rh)		vmulq_f32(r_lh, r_rh)
+#define vec4fRegDiv(r_lh, r_rh)		vdivq_f32(r_lh, r_rh)
+#define vec4fRegSqrt(r)				vsqrtq_f32(r)
+#define vec4fRegSelectGt(r, r_lh, r_rh)	vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(r), vcgtq_f32(r_lh, r_rh)))
+#endif	// SIMD
+
+
+//-----------------------------------------------------------------------------
+
+ijk_inl vec4f* vec4fZero(vec4f* const v_out)
+{
+#if (defined vec_simd)
+	v_out->m = vec4fRegSet(0.0f);
+#else	// !vec_simd
+	v_out->v[0] = v_out->v[1] = v_out->v[2] = v_out->v[3] = 0.0f;
+#endif	// vec_simd
+	return v_out;
+}
+
+ijk_inl vec4f* vec4fInit(vec4f* const v_out, float_t const x, float_t const y, float_t const z, float_t const w)
+{
+	v_out->v[0] = x;
+	v_out->v[1] = y;
+	v_out->v[2] = z;
+	v_out->v[3] = w;
+	return v_out;
+}
+
+ijk_inl vec4f* vec4fInit3(vec4f* const v_out, float3_t const v, float_t const w)
+{
+	return vec4fInit(v_out, v[0], v[1], v[2], w);
+}
+
+ijk_inl floatv_t vec4fGet3(float3_t v_out, vec4f const* const v)
+{
+	return vec3fInit(v_out, v->v[0], v->v[1], v->v[2]);
+}
+
+ijk_inl vec4f* vec4fNegate(vec4f* const v_out, vec4f const* const v)
+{
+#if (defined vec_simd)
+	v_out->m = vec4fRegSub(vec4fRegSet(0.0f), v->m);
+#else	// !vec_simd
+	v_out->v[0] = -v->v[0];
+	v_out->v[1] = -v->v[1];
+	v_out->v[2] = -v->v[2];
+	v_out->v[3] = -v->v[3];
+#endif	// vec_simd
+	return v_out;
+}
+
+ijk_inl float_t vec4fDot(vec4f const* const v_lh, vec4f const* const v_rh)
+{
+	// summed as (x + y) + (z + w), which matches 3D dot when 'w' is zero
+#if (defined vec_simd_sse)
+	__m128 const m = _mm_mul_ps(v_lh->m, v_rh->m);
+	__m128 const s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehl_ps(s, s)));
+#elif (defined vec_simd_neon)
+	float32x4_t const m = vmulq_f32(v_lh->m, v_rh->m);
+	float32x2_t const s = vpadd_f32(vget_low_f32(m), vget_high_f32(m));
+	return vget_lane_f32(vpadd_f32(s, s), 0);
+#else	// !SIMD
+	return ((v_lh->v[0] * v_rh->v[0] + v_lh->v[1] * v_rh->v[1]) + (v_lh->v[2] * v_rh->v[2] + v_lh->v[3] * v_rh->v[3]));
+#endif	// SIMD
+}
+
+ijk_inl vec4f* vec4fCross(vec4f* const v_out, vec4f const* const v_lh, vec4f const* const v_rh)
+{
+#if (defined vec_simd_sse)
+	__m128 const lh_yzx = _mm_shuffle_ps(v_lh->m, v_lh->m, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 const lh_zxy = _mm_shuffle_ps(v_lh->m, v_lh->m, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 const rh_yzx = _mm_shuffle_ps(v_rh->m, v_rh->m, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 const rh_zxy = _mm_shuffle_ps(v_rh->m, v_rh->m, _MM_SHUFFLE(3, 1, 0, 2));
+	v_out->m = _mm_sub_ps(_mm_mul_ps(lh_yzx, rh_zxy), _mm_mul_ps(lh_zxy, rh_yzx));
+	v_out->v[3] = 0.0f;
+#else	// !vec_simd_sse
+	float3_t cross;
+	vec3fCross(cross, v_lh->v, v_rh->v);
+	vec4fInit3(v_out, cross, 0.0f);
+#endif	// vec_simd_sse
+	return v_out;
+}
+
+ijk_inl float_t vec4fLenSq(vec4f const* const v)
+{
+	return vec4fDot(v, v);
+}
+
+ijk_inl float_t vec4fLen(vec4f const* const v)
+{
+	return fSqrt(vec4fLenSq(v));
+}
+
+ijk_inl float_t vec4fLenInv(vec4f const* const v)
+{
+	float_t const lenSq = vec4fLenSq(v);
+	return (lenSq > epsf ? 1.0f / fSqrt(lenSq) : 0.0f);
+}
+
+ijk_inl vec4f* vec4fAdd(vec4f* const v_out, vec4f const* const v_lh, vec4f const* const v_rh)
+{
+#if (defined vec_simd)
+	v_out->m = vec4fRegAdd(v_lh->m, v_rh->m);
+#else	// !vec_simd
+	v_out->v[0] = v_lh->v[0] + v_rh->v[0];
+	v_out->v[1] = v_lh->v[1] + v_rh->v[1];
+	v_out->v[2] = v_lh->v[2] + v_rh->v[2];
+	v_out->v[3] = v_lh->v[3] + v_rh->v[3];
+#endif	// vec_simd
+	return v_out;
+}
+
+ijk_inl vec4f* vec4fSub(vec4f* const v_out, vec4f const* const v_lh, vec4f const* const v_rh)
+{
+#if (defined vec_simd)
+	v_out->m = vec4fRegSub(v_lh->m, v_rh->m);
+#else	// !vec_simd
+	v_out->v[0] = v_lh->v[0] - v_rh->v[0];
+	v_out->v[1] = v_lh->v[1] - v_rh->v[1];
+	v_out->v[2] = v_lh->v[2] - v_rh->v[2];
+	v_out->v[3] = v_lh->v[3] - v_rh->v[3];
+#endif	// vec_simd
+	return v_out;
+}
+
+ijk_inl vec4f* vec4fMul(vec4f* const v_out, vec4f const* const v_lh, float_t const s_rh)
+{
+#if (defined vec_simd)
+	v_out->m = vec4fRegMul(v_lh->m, vec4fRegSet(s_rh));
+#else	// !vec_simd
+	v_out->v[0] = v_lh->v[0] * s_rh;
+	v_out->v[1] = v_lh->v[1] * s_rh;
+	v_out->v[2] = v_lh->v[2] * s_rh;
+	v_out->v[3] = v_lh->v[3] * s_rh;
+#endif	// vec_simd
+	return v_out;
+}
+
+ijk_inl vec4f* vec4fMad(vec4f* const v_out, vec4f const* const v0, vec4f const* const dv, float_t const u)
+{
+#if (defined vec_simd)
+	v_out->m = vec4fRegAdd(v0->m, vec4fRegMul(dv->m, vec4fRegSet(u)));
+#else	// !vec_simd
+	v_out->v[0] = fMad(v0->v[0], dv->v[0], u);
+	v_out->v[1] = fMad(v0->v[1], dv->v[1], u);
+	v_out->v[2] = fMad(v0->v[2], dv->v[2], u);
+	v_out->v[3] = fMad(v0->v[3], dv->v[3], u);
+#endif	// vec_simd
+	return v_out;
+}
+
+ijk_inl vec4f* vec4fUnit(vec4f* const v_out, vec4f const* const v)
+{
+	return vec4fMul(v_out, v, vec4fLenInv(v));
+}
+
+
+//-----------------------------------------------------------------------------
+
+ijk_inl floatv_t vec3fStreamDot(floatv_t s_out, vec3fStream const* const v_lh, vec3fStream const* const v_rh, size_t const count)
+{
+	size_t i = 0;
+#if (defined vec_simd)
+	for (; i + 4 <= count; i += 4)
+		vec4fRegStore(s_out + i, vec4fRegAdd(vec4fRegAdd(
+			vec4fRegMul(vec4fRegLoad(v_lh->x + i), vec4fRegLoad(v_rh->x + i)),
+			vec4fRegMul(vec4fRegLoad(v_lh->y + i), vec4fRegLoad(v_rh->y + i))),
+			vec4fRegMul(vec4fRegLoad(v_lh->z + i), vec4fRegLoad(v_rh->z + i))));
+#endif	// vec_simd
+	for (; i < count; ++i)
+		s_out[i] = (v_lh->x[i] * v_rh->x[i] + v_lh->y[i] * v_rh->y[i] + v_lh->z[i] * v_rh->z[i]);
+	return s_out;
+}
+
+ijk_inl floatv_t vec3fStreamLenSq(floatv_t s_out, vec3fStream const* const v, size_t const count)
+{
+	return vec3fStreamDot(s_out, v, v, count);
+}
+
+ijk_inl vec3fStream const* vec3fStreamMad(vec3fStream const* const v_out, vec3fStream const* const v0, vec3fStream const* const dv, float_t const u, size_t const count)
+{
+	size_t i = 0;
+#if (defined vec_simd)
+	vec4freg_t const r_u = vec4fRegSet(u);
+	for (; i + 4 <= count; i += 4)
+	{
+		vec4fRegStore(v_out->x + i, vec4fRegAdd(vec4fRegLoad(v0->x + i), vec4fRegMul(vec4fRegLoad(dv->x + i), r_u)));
+		vec4fRegStore(v_out->y + i, vec4fRegAdd(vec4fRegLoad(v0->y + i), vec4fRegMul(vec4fRegLoad(dv->y + i), r_u)));
+		vec4fRegStore(v_out->z + i, vec4fRegAdd(vec4fRegLoad(v0->z + i), vec4fRegMul(vec4fRegLoad(dv->z + i), r_u)));
+	}
+#endif	// vec_simd
+	for (; i < count; ++i)
+	{
+		v_out->x[i] = fMad(v0->x[i], dv->x[i], u);
+		v_out->y[i] = fMad(v0->y[i], dv->y[i], u);
+		v_out->z[i] = fMad(v0->z[i], dv->z[i], u);
+	}
+	return v_out;
+}
+
+ijk_inl vec3fStream const* vec3fStreamUnit(vec3fStream const* const v_out, vec3fStream const* const v, size_t const count)
+{
+	size_t i = 0;
+	float_t lenSq, lenInv;
+#if (defined vec_simd)
+	vec4freg_t const r_one = vec4fRegSet(1.0f), r_eps = vec4fRegSet(epsf);
+	for (; i + 4 <= count; i += 4)
+	{
+		vec4freg_t const r_x = vec4fRegLoad(v->x + i), r_y = vec4fRegLoad(v->y + i), r_z = vec4fRegLoad(v->z + i);
+		vec4freg_t const r_lenSq = vec4fRegAdd(vec4fRegAdd(vec4fRegMul(r_x, r_x), vec4fRegMul(r_y, r_y)), vec4fRegMul(r_z, r_z));
+		vec4freg_t const r_lenInv = vec4fRegSelectGt(vec4fRegDiv(r_one, vec4fRegSqrt(r_lenSq)), r_lenSq, r_eps);
+		vec4fRegStore(v_out->x + i, vec4fRegMul(r_x, r_lenInv));
+		vec4fRegStore(v_out->y + i, vec4fRegMul(r_y, r_lenInv));
+		vec4fRegStore(v_out->z + i, vec4fRegMul(r_z, r_lenInv));
+	}
+#endif	// vec_simd
+	for (; i < count; ++i)
+	{
+		lenSq = (v->x[i] * v->x[i] + v->y[i] * v->y[i] + v->z[i] * v->z[i]);
+		lenInv = (lenSq > epsf ? 1.0f / fSqrt(lenSq) : 0.0f);
+		v_out->x[i] = v->x[i] * lenInv;
+		v_out->y[i] = v->y[i] * lenInv;
+		v_out->z[i] = v->z[i] * lenInv;
+	}
+	return v_out;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !_VEC4F_INL_
+#endif	// _VEC4F_H_
\ No newline at end of file
@@ -24,8 +24,295 @@
 */
 
 #include "_util/scene.h"
+#include "_util/shape.inl"
+#include "_util/vec4f.h"
+#include "_util/kernel.h"
+#include "_util/ijkTimer.h"
+#include "_util/ijkThread.h"
+#include "_util/ijkProfiler.h"
+#include "_util/ijkPerf.h"
+#include "_util/ijkHistogram.h"
+#include "_util/ijkMetrics.h"
+#include "_util/ijkRing.h"
+#include "_util/ijkRecording.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#if ijk_platform_is(WINDOWS)
+#include <io.h>
+#include <fcntl.h>
+#endif	// WINDOWS
+
+
+//-----------------------------------------------------------------------------
+// COUNTERS
+
+// If defined, hot-path counters are compiled in; a thread only counts 
+//	while it has a counter block bound, so counters cost one predictable 
+//	branch each while not shown
+#define IJK_PLAYER_COUNTERS
+
+// Hot-path counters
+typedef enum eCounter_t
+{
+	counter_rays,				// Primary rays generated
+	counter_testsSphere,		// Ray tests against spheres
+	counter_testsCylinder,		// Ray tests against cylinders
+	counter_hits,				// Ray tests that hit
+	counter_shadowRays,			// Shadow rays traced
+	counter_cellsChanged,		// Presented cells whose color changed
+	counter_bytes,				// Bytes emitted to output
+	counter_syscalls,			// Writes and flushes issued to output
+	counter_consoleCalls,		// Console calls (cursor, color, clear)
+	counter_count
+} eCounter;
+
+// Counter names, as reported
+static kstr const counterName[counter_count] = { "rays", "tests_sphere", "tests_cylinder", "hits", "shadow_rays", "cells_changed", "bytes", "syscalls", "console_calls" };
+
+// Counter block of one thread
+//	-> padded to whole cache lines; each thread only writes its own block, 
+//		and blocks are merged once a frame is done
+typedef struct sCounters_t
+{
+	ui64 count[counter_count];	// Count per counter
+	ui64 pad[16 - counter_count];
+} sCounters;
+
+#ifdef IJK_PLAYER_COUNTERS
+// Counter block bound to current thread, null while not counting
+static ijk_threadlocal sCounters* countersLocal;
+
+// Add to counter of current thread, if counting
+#define counters_add(counter,n)		((void)(countersLocal && (countersLocal->count[counter] += (ui64)(n))))
+// Bind counter block to current thread (null stops counting)
+#define counters_bind(counters)		((void)(countersLocal = (counters)))
+#else	// !IJK_PLAYER_COUNTERS
+#define counters_add(counter,n)		((void)0)
+#define counters_bind(counters)		((void)0)
+#endif	// IJK_PLAYER_COUNTERS
+
+// Reset counter block
+ijk_inl void fCountersReset(sCounters* const counters)
+{
+	sCounters const reset = { 0 };
+	*counters = reset;
+}
+
+// Add counter block to another
+ijk_inl void fCountersMerge(sCounters* const counters, sCounters const* const counters_other)
+{
+	ui32 i;
+	for (i = 0; i < counter_count; ++i)
+		counters->count[i] += counters_other->count[i];
+}
+
+
+//-----------------------------------------------------------------------------
+// HARDWARE COUNTERS
+
+// Stages measured with hardware counters
+//	-> a thread measures while it has a stage block bound with counters 
+//		open; stages read the counters on entry and exit, so each costs a 
+//		system call or two rather than a branch
+//	-> Windows only provides the thread's cycle count: cycles are reported 
+//		per stage, other counters (and so IPC) are null
+typedef enum ePerfStage_t
+{
+	perf_render,				// Whole render of a frame, any engine
+	perf_raygen,				// Wavefront: generate primary rays
+	perf_intersect,				// Wavefront: intersect shapes
+	perf_compact,				// Wavefront: queue shading and shadow rays
+	perf_shade,					// Wavefront: trace shadow rays
+	perf_encode,				// Encode frame for terminal
+	perf_present,				// Present encoded frame to sink
+	perf_stageCount
+} ePerfStage;
+
+// Stage and counter names, as reported
+static kstr const perfStageName[perf_stageCount] = { "render", "raygen", "intersect", "compact", "shade", "encode", "present" };
+static kstr const perfCounterName[ijkPerfCounter_count] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+
+// Stage block of one thread: counts per stage, and counters that were 
+//	available on every thread merged into it
+typedef struct sPerfStages_t
+{
+	ijkPerf perf;				// Counters of owning thread, open while measuring
+	bool available[ijkPerfCounter_count];	// Counter available on every thread merged
+	ui64 count[perf_stageCount][ijkPerfCounter_count];	// Counts per stage
+	ui64 start[perf_stageCount][ijkPerfCounter_count];	// Counts when stage was entered
+} sPerfStages;
+
+// Stage block bound to current thread, null while not measuring
+static ijk_threadlocal sPerfStages* perfLocal;
+
+// Open counters for calling thread; returns whether any are available
+ijk_inl bool fPerfStagesOpen(sPerfStages* const stages)
+{
+	sPerfStages const reset = { 0 };
+	iret status;
+	*stages = reset;
+	status = ijkPerfOpen(&stages->perf);
+	memcpy(stages->available, stages->perf.available, sizeof(stages->available));
+	return ijk_issuccess(status);
+}
+
+// Close counters of stage block, keeping counts
+ijk_inl void fPerfStagesClose(sPerfStages* const stages)
+{
+	ijkPerfClose(&stages->perf);
+}
+
+// Add counts and availability of stage block to another
+ijk_inl void fPerfStagesMerge(sPerfStages* const stages, sPerfStages const* const stages_other)
+{
+	ui32 i, j;
+	for (j = 0; j < ijkPerfCounter_count; ++j)
+		stages->available[j] = stages->available[j] && stages_other->available[j];
+	for (i = 0; i < perf_stageCount; ++i)
+		for (j = 0; j < ijkPerfCounter_count; ++j)
+			stages->count[i][j] += stages_other->count[i][j];
+}
+
+// Whether any counter was available on every thread merged
+ijk_inl bool fPerfStagesAny(sPerfStages const* const stages)
+{
+	ui32 j;
+	bool any = false;
+	for (j = 0; j < ijkPerfCounter_count; ++j)
+		any = any || stages->available[j];
+	return any;
+}
+
+// Enter stage on stage block
+ijk_inl void fPerfStageBegin(sPerfStages* const stages, ePerfStage const stage)
+{
+	ijkPerfRead(&stages->perf, stages->start[stage]);
+}
+
+// Leave stage on stage block, adding counts since it was entered
+ijk_inl void fPerfStageEnd(sPerfStages* const stages, ePerfStage const stage)
+{
+	ui64 count[ijkPerfCounter_count];
+	ui32 j;
+	ijkPerfRead(&stages->perf, count);
+	for (j = 0; j < ijkPerfCounter_count; ++j)
+		stages->count[stage][j] += count[j] - stages->start[stage][j];
+}
+
+// Enter and leave stage on current thread, if measuring
+#define perf_begin(stage)			(perfLocal ? fPerfStageBegin(perfLocal, stage) : (void)0)
+#define perf_end(stage)				(perfLocal ? fPerfStageEnd(perfLocal, stage) : (void)0)
+// Bind stage block to current thread (null stops measuring)
+#define perf_bind(stages)			((void)(perfLocal = (stages)))
+
+
+//-----------------------------------------------------------------------------
+// METRICS
+
+// Create metrics file of this instance, if a directory is given ("-" is 
+//	the shared directory); failing only loses the export
+ijk_inl bool fMetricsCreate(ijkMetricsFile* const file, kstr const directory, kstr const name)
+{
+	if (!directory[0])
+		return false;
+	if (ijk_issuccess(ijkMetricsCreate(file, strcmp(directory, "-") ? directory : ijkMapGetSharedDirectory(), name)))
+		return true;
+	dprintf("metrics: could not create file in '%s'\n", directory);
+	return false;
+}
+
+// Publish frame to metrics file, if created
+//	-> publishing is two atomic stores and a copy, so the render loop 
+//		never waits on readers
+ijk_inl void fMetricsPublish(ijkMetricsFile const* const file, f64 const ms, f64 const fps, ui64 const rays, ui64 const bytes)
+{
+	ijkMetricsData data = { 0 };
+	if (!file->metrics)
+		return;
+	data.frameMs = ms;
+	data.fps = fps;
+	data.raysPerSec = ms > 0.0 ? (f64)rays * 1000.0 / ms : 0.0;
+	data.bytesPerFrame = (f64)bytes;
+	ijkMetricsPublish(file->metrics, &data);
+}
+
+
+//-----------------------------------------------------------------------------
+// FRAME RING
+
+// Frames held in ring for consumers that fall behind
+#define ring_slots 16
+
+// Narrow frame colors to one byte per cell, as shared and recorded
+ijk_inl void fCellsFromColors(byte* const cells, ijkConsoleColor const* const color, ui32 const count)
+{
+	ui32 i;
+	for (i = 0; i < count; ++i)
+		cells[i] = (byte)(color[i] & 0xf);
+}
+
+// Create frame ring of this instance, if a directory is given ("-" is 
+//	the shared directory); failing only loses the ring
+ijk_inl bool fRingCreate(ijkRingFile* const file, kstr const directory, ui16 const width, ui16 const height)
+{
+	if (!directory[0])
+		return false;
+	if (ijk_issuccess(ijkRingCreate(file, strcmp(directory, "-") ? directory : ijkMapGetSharedDirectory(), width, height, ring_slots)))
+		return true;
+	dprintf("ring: could not create file in '%s'\n", directory);
+	return false;
+}
+
+// Publish finished frame colors to ring, if created
+//	-> colors are narrowed straight into the slot, which is the only 
+//		copy; consumers read the slot in place
+ijk_inl void fRingPublish(ijkRingFile const* const file, ijkConsoleColor const* const color, ui32 const frame)
+{
+	if (!file->ring)
+		return;
+	fCellsFromColors(ijkRingWriteBegin(file->ring), color, (ui32)file->ring->width * (ui32)file->ring->height);
+	ijkRingWriteEnd(file->ring, frame);
+}
+
+
+//-----------------------------------------------------------------------------
+// RECORDING
+
+// Frames from one keyframe to the next in recordings
+#define record_keyInterval 60
+
+// Start recording to file, if a path is given; failing only loses the 
+//	recording
+ijk_inl bool fRecordCreate(ijkRecorder* const recorder, kstr const path, ui16 const width, ui16 const height)
+{
+	if (!path[0])
+		return false;
+	if (ijk_issuccess(ijkRecorderOpen(recorder, path, width, height, record_keyInterval)))
+		return true;
+	dprintf("record: could not create '%s'\n", path);
+	return false;
+}
+
+// Queue finished frame colors for recording, if recording
+//	-> colors are narrowed into the queue; the recording thread encodes 
+//		and writes them, so this only waits if it falls a queue behind
+ijk_inl void fRecordFrame(ijkRecorder* const recorder, ijkConsoleColor const* const color, ui32 const frame)
+{
+	if (!recorder->file)
+		return;
+	fCellsFromColors(ijkRecorderBegin(recorder), color, (ui32)recorder->header.width * (ui32)recorder->header.height);
+	ijkRecorderEnd(recorder, frame);
+}
+
+// Finish recording, if recording
+ijk_inl void fRecordClose(ijkRecorder* const recorder, kstr const path)
+{
+	if (recorder->file && !ijk_issuccess(ijkRecorderClose(recorder)))
+		dprintf("record: write to '%s' failed\n", path);
+}
 
 
 //-----------------------------------------------------------------------------
@@ -77,6 +364,133 @@ ijk_inl bool fViewportGetViewCoord(sViewport const* const viewport, float3_t coo
 	return true;
 }
 
+// Convert offset location in viewport to scene view coord
+//	-> offsets are fractions of a pixel, where the pixel's own coord (above) 
+//		is at zero and neighboring pixels are at +/-1
+ijk_inl bool fViewportGetViewCoordOffset(sViewport const* const viewport, float3_t coord_out, ui16 const x_viewport, ui16 const y_viewport, float_t const dx_viewport, float_t const dy_viewport)
+{
+	if (!viewport || !viewport->width || !coord_out)
+		return false;
+
+	float_t const u = ((float_t)(x_viewport) + dx_viewport) * viewport->widthInv;
+	float_t const v = ((float_t)(viewport->height - 1 - y_viewport) - dy_viewport) * viewport->heightInv;
+	float_t const x_ndc = (u * 2.0f - 1.0f);
+	float_t const y_ndc = (v * 2.0f - 1.0f);
+	coord_out[0] = x_ndc * 0.5f * viewport->viewWidth;
+	coord_out[1] = y_ndc * 0.5f * viewport->viewHeight;
+	coord_out[2] = -viewport->viewDist;
+	return true;
+}
+
+// Convert scene view coord on the viewport plane to nearest location in viewport
+//	-> returns false if coord falls outside of viewport
+ijk_inl bool fViewportGetPixel(sViewport const* const viewport, float3_t const coord, ui16* const x_viewport_out, ui16* const y_viewport_out)
+{
+	if (!viewport || !viewport->width || !coord || !x_viewport_out || !y_viewport_out)
+		return false;
+
+	float_t const x_ndc = coord[0] * 2.0f / viewport->viewWidth;
+	float_t const y_ndc = coord[1] * 2.0f / viewport->viewHeight;
+	float_t const u = (x_ndc + 1.0f) * 0.5f;
+	float_t const v = (y_ndc + 1.0f) * 0.5f;
+	float_t const x = u * (float_t)viewport->width + 0.5f;
+	float_t const y = (float_t)viewport->height - v * (float_t)viewport->height - 0.5f;
+	if (x < 0.0f || x >= (float_t)viewport->width || y < 0.0f || y >= (float_t)viewport->height)
+		return false;
+
+	*x_viewport_out = (ui16)x;
+	*y_viewport_out = (ui16)y;
+	return true;
+}
+
+
+// Camera descriptor
+//	-> NOTE: camera places the viewer's space in the scene: viewer is at 
+//		'location' and rotated by 'yaw' radians about scene y (positive 
+//		turns left); default camera matches the fixed viewer at the origin
+typedef struct sCamera_t
+{
+	vec3f location;				// Location of viewer in scene
+	f32 yaw;					// Rotation of viewer about scene y axis
+	f32 yawCos, yawSin;			// Cosine and sine of yaw
+} sCamera;
+
+// Initialize camera
+ijk_inl bool fCameraInit(sCamera* const camera, float3_t const location, f32 const yaw)
+{
+	extern f64 cos(f64);
+	extern f64 sin(f64);
+	if (!camera || !location)
+		return false;
+
+	vec3fCopy(camera->location.v, location);
+	camera->yaw = yaw;
+	camera->yawCos = (f32)cos((f64)yaw);
+	camera->yawSin = (f32)sin((f64)yaw);
+	return true;
+}
+
+// Test if two cameras describe the same view
+ijk_inl bool fCameraIsEqual(sCamera const* const camera_lh, sCamera const* const camera_rh)
+{
+	return (camera_lh->yaw == camera_rh->yaw &&
+		camera_lh->location.x == camera_rh->location.x &&
+		camera_lh->location.y == camera_rh->location.y &&
+		camera_lh->location.z == camera_rh->location.z);
+}
+
+// Rotate vector from viewer's space to scene
+ijk_inl floatv_t fCameraRotateToScene(sCamera const* const camera, float3_t v_out, float3_t const v_eye)
+{
+	float3_t const v = {
+		v_eye[0] * camera->yawCos + v_eye[2] * camera->yawSin,
+		v_eye[1],
+		v_eye[2] * camera->yawCos - v_eye[0] * camera->yawSin,
+	};
+	return vec3fCopy(v_out, v);
+}
+
+// Rotate vector from scene to viewer's space
+ijk_inl floatv_t fCameraRotateToEye(sCamera const* const camera, float3_t v_out, float3_t const v_scene)
+{
+	float3_t const v = {
+		v_scene[0] * camera->yawCos - v_scene[2] * camera->yawSin,
+		v_scene[1],
+		v_scene[2] * camera->yawCos + v_scene[0] * camera->yawSin,
+	};
+	return vec3fCopy(v_out, v);
+}
+
+// Transform point from scene to viewer's space
+ijk_inl floatv_t fCameraTransformToEye(sCamera const* const camera, float3_t v_out, float3_t const v_scene)
+{
+	float3_t d;
+	vec3fSub(d, v_scene, camera->location.v);
+	return fCameraRotateToEye(camera, v_out, d);
+}
+
+// Move camera relative to its own orientation
+ijk_inl bool fCameraMove(sCamera* const camera, f32 const right, f32 const up, f32 const forward)
+{
+	if (!camera)
+		return false;
+
+	float3_t const delta_eye = { right, up, -forward };
+	float3_t delta;
+	fCameraRotateToScene(camera, delta, delta_eye);
+	vec3fAdd(camera->location.v, camera->location.v, delta);
+	return true;
+}
+
+// Turn camera about scene y axis
+ijk_inl bool fCameraTurn(sCamera* const camera, f32 const yaw_delta)
+{
+	if (!camera)
+		return false;
+
+	return fCameraInit(camera, camera->location.v, camera->yaw + yaw_delta);
+}
+
 
 // Ray descriptor
 typedef struct sRay_t
@@ -109,136 +523,3288 @@ ijk_inl bool fRayInitOrtho(sRay* const ray, float3_t const center_eye, float3_t
 	return true;
 }
 
+// Move ray from viewer's space into scene using camera
+ijk_inl bool fRayToScene(sRay* const ray, sCamera const* const camera)
+{
+	if (!ray || !camera)
+		return false;
+
+	fCameraRotateToScene(camera, ray->origin.v, ray->origin.v);
+	vec3fAdd(ray->origin.v, ray->origin.v, camera->location.v);
+	fCameraRotateToScene(camera, ray->direction.v, ray->direction.v);
+	return true;
+}
+
+// Initialize primary ray in scene through location in viewport (perspective)
+ijk_inl bool fRayInitPrimary(sRay* const ray, sViewport const* const viewport, sCamera const* const camera, ui16 const x_viewport, ui16 const y_viewport)
+{
+	float3_t coord;
+	counters_add(counter_rays, 1);
+	return (fViewportGetViewCoord(viewport, coord, x_viewport, y_viewport) &&
+		fRayInitPersp(ray, vec3f0.v, coord) &&
+		fRayToScene(ray, camera));
+}
+
+// Initialize primary ray in scene through offset location in viewport (perspective)
+ijk_inl bool fRayInitPrimaryOffset(sRay* const ray, sViewport const* const viewport, sCamera const* const camera, ui16 const x_viewport, ui16 const y_viewport, float_t const dx_viewport, float_t const dy_viewport)
+{
+	float3_t coord;
+	counters_add(counter_rays, 1);
+	return (fViewportGetViewCoordOffset(viewport, coord, x_viewport, y_viewport, dx_viewport, dy_viewport) &&
+		fRayInitPersp(ray, vec3f0.v, coord) &&
+		fRayToScene(ray, camera));
+}
+
 
 //-----------------------------------------------------------------------------
-// DISPLAY
+// CULLING
 
-// ****TO-DO: read me
-//	Hello! Your goal is to generate a very primitive ray-traced scene directly 
-//	in the console.  This is the only file you should modify and submit, but 
-//	have a look at the following header files to see what tools you have: 
-//		-> "_utils/vec3f.h" - basic 3D float vector interface
-//		-> "_utils/scene.h" - scene descriptor (already set up and final)
-//	Please do the following: 
-//		-> Implement the blocks that say ****TO-DO
-//		-> Write lots of comments to document your thoughts
-//		-> Submit ONLY THIS FILE when you are done; follow Canvas instructions
-//		-> Have fun!
+// Bounds in viewport (inclusive)
+typedef struct sRect_t
+{
+	i16 x0, y0, x1, y1;
+} sRect;
 
-// Ray hit record
-typedef struct sRecord_t
+// Culling modes for primary rays
+typedef enum eCull_t
 {
-	ui16 type, index;
-	float_t dist;
-} sRecord;
+	cull_none,					// Test every shape
+	cull_bins,					// Test shapes binned to pixel's screen tile
+	cull_sorted,				// Test visible shapes front to back, stop early
+	cull_sortedBins,			// Test shapes binned to tile, front to back
+	cull_count
+} eCull;
 
-// Test ray against sphere
-ijk_inl bool fRayTestSphere(sRay const* const ray, sScene const* const scene, ui16 const shapeIndex, sRecord* const hit_out)
+// Size of screen tile in pixels per side
+#define cull_tileSize 8
+
+// Culling descriptor
+//	-> lists the shapes each primary ray should test: without culling this 
+//		is every shape; with bins, each shape's bounds are projected into 
+//		the viewport once per frame and it is listed in every tile they 
+//		touch, so rays only test shapes that can cover their pixel
+//	-> sorted lists hold visible shapes ordered by the nearest they can be 
+//		to the viewer, so a ray can stop testing once its closest hit is 
+//		nearer than the next shape could be; tiles are filled in list order, 
+//		so they are sorted too
+//	-> tile lists are packed one after the other; tile i owns entries 
+//		offset[i] up to offset[i + 1]
+typedef struct sCull_t
 {
-	assert(shapeIndex < scene_numSpheres);
+	eCull mode;					// Culling mode of current lists
+	ui16 tilesX, tilesY;		// Number of tiles across and down
+	ui32 shapes;				// Number of shapes in scene
+	ui32 visible;				// Shapes with bounds in viewport
+	ui32 entries, capacity;		// Tile entries in use and allocated
+	sShapeRef* shape;			// Every shape in scene
+	sShapeRef* list;			// Visible shapes, sorted if requested
+	sShapeRef* bin;				// Shapes per tile
+	ui32* offset;				// First entry per tile, plus end of last tile
+	sRect* rect;				// Bounds in viewport per shape
+} sCull;
 
-	vec3f location;
-	float_t radius;
-	fSphereGet(scene, shapeIndex, &location, &radius);
+// Project box in viewer's space (center and half extents) to bounds in viewport
+//	-> bounds are conservative: each side takes whichever corner of the box 
+//		lands furthest out, then is padded by a pixel for sub-pixel rays
+//	-> returns false if box is entirely behind viewer or outside of 
+//		viewport; a box reaching the viewer's plane may land anywhere, so it 
+//		covers the whole viewport
+ijk_inl bool fViewportGetBounds(sViewport const* const viewport, float3_t const center_eye, float3_t const extent_eye, sRect* const rect_out)
+{
+	float_t const depthNear = -center_eye[2] - extent_eye[2], depthFar = -center_eye[2] + extent_eye[2];
+	float_t const right = (float_t)(viewport->width - 1), bottom = (float_t)(viewport->height - 1);
+	float_t x0, y0, x1, y1;
+
+	if (depthFar <= epsf)
+		return false;
+	if (depthNear <= epsf)
+	{
+		rect_out->x0 = rect_out->y0 = 0;
+		rect_out->x1 = (i16)right;
+		rect_out->y1 = (i16)bottom;
+		return true;
+	}
 
-	// ****TO-DO: implement me
-	//	-> if we hit something, write record and return true
-	//	-> if we did not hit something, return false
+	// extents on viewport plane: positive sides are furthest out when near
+	x0 = center_eye[0] - extent_eye[0];
+	x1 = center_eye[0] + extent_eye[0];
+	y0 = center_eye[1] - extent_eye[1];
+	y1 = center_eye[1] + extent_eye[1];
+	x0 *= viewport->viewDist / (x0 < 0.0f ? depthNear : depthFar);
+	x1 *= viewport->viewDist / (x1 > 0.0f ? depthNear : depthFar);
+	y0 *= viewport->viewDist / (y0 < 0.0f ? depthNear : depthFar);
+	y1 *= viewport->viewDist / (y1 > 0.0f ? depthNear : depthFar);
+
+	// to pixels (y flips, so top comes from y1)
+	x0 = (x0 / viewport->viewWidth + 0.5f) * (float_t)viewport->width - 1.0f;
+	x1 = (x1 / viewport->viewWidth + 0.5f) * (float_t)viewport->width + 1.0f;
+	y0 = bottom - (y0 / viewport->viewHeight + 0.5f) * (float_t)viewport->height + 1.0f;
+	y1 = bottom - (y1 / viewport->viewHeight + 0.5f) * (float_t)viewport->height - 1.0f;
+	if (x1 < 0.0f || y0 < 0.0f || x0 > right || y1 > bottom)
+		return false;
 
+	rect_out->x0 = (i16)ijk_maximum(x0, 0.0f);
+	rect_out->y0 = (i16)ijk_maximum(y1, 0.0f);
+	rect_out->x1 = (i16)ijk_minimum(x1, right);
+	rect_out->y1 = (i16)ijk_minimum(y0, bottom);
 	return true;
 }
 
-// Test ray against finite cylinder
-ijk_inl bool fRayTestCylinderFinite(sRay const* const ray, sScene const* const scene, ui16 const shapeIndex, sRecord* const hit_out)
+// Get bounding box of shape in viewer's space (center and half extents)
+ijk_inl bool fShapeGetBoundsEye(sScene const* const scene, sCamera const* const camera, sShapeRef const* const shape, float3_t center_out, float3_t extent_out)
 {
-	assert(shapeIndex < scene_numCylinders);
+	vec3f location, location_cap1, axis;
+	float_t radius, lenSqInv, a;
+	ui16 i;
 
-	vec3f location_cap0;
-	vec3f location_cap1;
-	float_t radius;
-	fCylinderGet(scene, shapeIndex, &location_cap0, &location_cap1, &radius);
+	switch (shape->type)
+	{
+	case shape_sphere:
+		fSphereGet(scene, shape->index, &location, &radius);
+		fCameraTransformToEye(camera, center_out, location.v);
+		vec3fInit(extent_out, radius, radius, radius);
+		return true;
+	case shape_cylinder:
+		fCylinderGet(scene, shape->index, &location, &location_cap1, &radius);
+		vec3fSub(axis.v, location_cap1.v, location.v);
+		vec3fMad(location.v, location.v, axis.v, 0.5f);
+		fCameraTransformToEye(camera, center_out, location.v);
+		fCameraRotateToEye(camera, axis.v, axis.v);
+
+		// half of axis, plus extent of cap disc perpendicular to it
+		lenSqInv = vec3fLenSqInv(axis.v);
+		for (i = 0; i < 3; ++i)
+		{
+			a = axis.v[i] < 0.0f ? -axis.v[i] : axis.v[i];
+			extent_out[i] = a * 0.5f + radius * fSqrt(ijk_maximum(1.0f - a * a * lenSqInv, 0.0f));
+		}
+		return true;
+	}
+	return false;
+}
+
+// Allocate culling lists for scene in viewport
+ijk_inl bool fCullCreate(sCull* const cull, sViewport const* const viewport, sScene const* const scene)
+{
+	if (!cull || !viewport || !scene || cull->shape || cull->list || cull->offset || cull->rect)
+		return false;
 
-	// NOTE: implement me instead of spheres for one bonus point (same idea, different algorithm)
+	ui32 const shapes = scene->numSpheres + scene->numCylinders;
+	ui16 const tilesX = (viewport->width + cull_tileSize - 1) / cull_tileSize;
+	ui16 const tilesY = (viewport->height + cull_tileSize - 1) / cull_tileSize;
+	ui32 i;
 
+	cull->shape = (sShapeRef*)malloc(shapes * sizeof(*cull->shape));
+	cull->list = (sShapeRef*)malloc(shapes * sizeof(*cull->list));
+	cull->rect = (sRect*)malloc(shapes * sizeof(*cull->rect));
+	cull->offset = (ui32*)malloc(((size_t)tilesX * (size_t)tilesY + 1) * sizeof(*cull->offset));
+	if (!cull->shape || !cull->list || !cull->rect || !cull->offset)
+	{
+		free(cull->shape);
+		free(cull->list);
+		free(cull->rect);
+		free(cull->offset);
+		cull->shape = cull->list = 0;
+		cull->rect = 0;
+		cull->offset = 0;
+		return false;
+	}
+	for (i = 0; i < shapes; ++i)
+	{
+		cull->shape[i].type = i < scene->numSpheres ? shape_sphere : shape_cylinder;
+		cull->shape[i].index = i < scene->numSpheres ? i : i - scene->numSpheres;
+		cull->shape[i].dist = 0.0f;
+	}
+	cull->mode = cull_none;
+	cull->tilesX = tilesX;
+	cull->tilesY = tilesY;
+	cull->shapes = cull->visible = shapes;
+	cull->entries = cull->capacity = 0;
+	cull->bin = 0;
 	return true;
 }
 
-// Calculate final color from ray in scene
-ijk_inl void fRayCalcColor(sRay const* const ray, sScene const* const scene, ijkConsoleColor* const color_out)
+// Release culling lists
+ijk_inl bool fCullRelease(sCull* const cull)
 {
-	// ****TO-DO: call the ray tests here and perform shading; there are two parts to this: 
-	//	1) keep track of the closest hit
-	//	2) use the closest hit to calculate shading; there is enough information in the scene to calculate 
-	//		the diffuse/Lambertian coefficient, which is used to estimate the color to pass back; the fail 
-	//		case is to pass back the background color
+	if (!cull)
+		return false;
 
-	*color_out = scene->color_bg;
+	free(cull->shape);
+	free(cull->list);
+	free(cull->bin);
+	free(cull->offset);
+	free(cull->rect);
+	cull->shape = cull->list = cull->bin = 0;
+	cull->offset = 0;
+	cull->rect = 0;
+	cull->shapes = cull->visible = cull->entries = cull->capacity = 0;
+	return true;
 }
 
+// Compare shapes by nearest possible distance from viewer (for sorting)
+ijk_inl int fShapeRefCompareDist(void const* const lh, void const* const rh)
+{
+	float_t const lhDist = ((sShapeRef const*)lh)->dist, rhDist = ((sShapeRef const*)rh)->dist;
+	return (lhDist > rhDist) - (lhDist < rhDist);
+}
 
-//-----------------------------------------------------------------------------
+// Build culling lists for frame seen by camera
+//	-> a shape's nearest possible distance is that of its eye space bounds 
+//		from the viewer, which primary rays start at
+//	-> falls back to no culling if tile lists cannot grow
+ijk_inl bool fCullUpdate(sCull* const cull, eCull const mode, sViewport const* const viewport, sScene const* const scene, sCamera const* const camera)
+{
+	float3_t center_eye, extent_eye, near_eye;
+	bool const sorted = (mode == cull_sorted || mode == cull_sortedBins);
+	bool const binned = (mode == cull_bins || mode == cull_sortedBins);
+	ui32 const tiles = (ui32)cull->tilesX * (ui32)cull->tilesY;
+	ui32 i, k, tile;
+	i16 tx, ty;
 
-ijk_inl void ijkConsoleDrawPixel(ijkConsole const* const console, ijkConsoleColor const color, i16 const x_viewport, i16 const y_viewport)
+	cull->mode = cull_none;
+	cull->visible = cull->shapes;
+	cull->entries = 0;
+
+	// bounds per shape, listing visible shapes; bounds are kept without 
+	//	culling too, for engines that check what may cover a block
+	for (i = 0, cull->visible = 0; i < cull->shapes; ++i)
+	{
+		sRect* const rect = cull->rect + i;
+		sShapeRef* const list = cull->list + cull->visible;
+		if (!fShapeGetBoundsEye(scene, camera, cull->shape + i, center_eye, extent_eye) ||
+			!fViewportGetBounds(viewport, center_eye, extent_eye, rect))
+		{
+			rect->x0 = rect->y0 = 0;
+			rect->x1 = rect->y1 = -1;
+			continue;
+		}
+		*list = cull->shape[i];
+		if (sorted)
+		{
+			for (k = 0; k < 3; ++k)
+			{
+				near_eye[k] = (center_eye[k] < 0.0f ? -center_eye[k] : center_eye[k]) - extent_eye[k];
+				near_eye[k] = ijk_maximum(near_eye[k], 0.0f);
+			}
+			list->dist = fSqrt(vec3fLenSq(near_eye));
+		}
+		++cull->visible;
+	}
+	if (mode == cull_none)
+	{
+		cull->visible = cull->shapes;
+		return true;
+	}
+	if (sorted)
+		qsort(cull->list, cull->visible, sizeof(*cull->list), fShapeRefCompareDist);
+	cull->mode = mode;
+	if (!binned)
+		return true;
+
+	// count entries per tile one slot ahead
+	for (tile = 0; tile <= tiles; ++tile)
+		cull->offset[tile] = 0;
+	for (i = 0; i < cull->shapes; ++i)
+	{
+		sRect const* const rect = cull->rect + i;
+		if (rect->x1 < rect->x0)
+			continue;
+		for (ty = rect->y0 / cull_tileSize; ty <= rect->y1 / cull_tileSize; ++ty)
+			for (tx = rect->x0 / cull_tileSize; tx <= rect->x1 / cull_tileSize; ++tx)
+				++cull->offset[(ui32)ty * (ui32)cull->tilesX + (ui32)tx + 1];
+	}
+
+	// counts to end of each tile
+	for (tile = 0; tile < tiles; ++tile)
+		cull->offset[tile + 1] += cull->offset[tile];
+	cull->entries = cull->offset[tiles];
+	if (cull->entries > cull->capacity)
+	{
+		sShapeRef* const bin = (sShapeRef*)realloc(cull->bin, cull->entries * sizeof(*cull->bin));
+		if (!bin)
+		{
+			cull->mode = cull_none;
+			cull->visible = cull->shapes;
+			cull->entries = 0;
+			return false;
+		}
+		cull->bin = bin;
+		cull->capacity = cull->entries;
+	}
+
+	// fill each tile from its start in list order, which leaves each offset 
+	//	at the start of the next tile, then shift back
+	for (k = 0; k < cull->visible; ++k)
+	{
+		sShapeRef const* const list = cull->list + k;
+		sRect const* const rect = cull->rect + (list->type == shape_sphere ? 0 : scene->numSpheres) + list->index;
+		for (ty = rect->y0 / cull_tileSize; ty <= rect->y1 / cull_tileSize; ++ty)
+			for (tx = rect->x0 / cull_tileSize; tx <= rect->x1 / cull_tileSize; ++tx)
+				cull->bin[cull->offset[(ui32)ty * (ui32)cull->tilesX + (ui32)tx]++] = *list;
+	}
+	for (tile = tiles; tile > 0; --tile)
+		cull->offset[tile] = cull->offset[tile - 1];
+	cull->offset[0] = 0;
+	return true;
+}
+
+// Get list of shapes to test for primary ray through location in viewport
+ijk_inl sShapeRef const* fCullGetList(sCull const* const cull, ui16 const x_viewport, ui16 const y_viewport, ui32* const count_out)
 {
-	ijkConsoleSetCursorColor(x_viewport * 2, y_viewport * 1, color, color);
-	printf("  ");
+	if (cull->mode == cull_bins || cull->mode == cull_sortedBins)
+	{
+		ui32 const tile = (ui32)(y_viewport / cull_tileSize) * (ui32)cull->tilesX + (ui32)(x_viewport / cull_tileSize);
+		*count_out = cull->offset[tile + 1] - cull->offset[tile];
+		return cull->bin + cull->offset[tile];
+	}
+	if (cull->mode == cull_sorted)
+	{
+		*count_out = cull->visible;
+		return cull->list;
+	}
+	*count_out = cull->shapes;
+	return cull->shape;
 }
 
-iret ijkConsoleDraw(ijkConsole const* const console)
+// Get bounds in viewport of shape to test, by its index in list of every shape
+//	-> without culling this is the whole viewport; returns false if culled
+ijk_inl bool fCullGetBounds(sCull const* const cull, sViewport const* const viewport, ui32 const shapeIndex, sRect* const rect_out)
 {
-	ui16 const width = 48, height = 27;
-	f32 const viewHeight = 2.0f, viewDist = 3.0f;
+	if (cull->mode != cull_none)
+	{
+		*rect_out = cull->rect[shapeIndex];
+		return (rect_out->x0 <= rect_out->x1);
+	}
+	rect_out->x0 = rect_out->y0 = 0;
+	rect_out->x1 = (i16)(viewport->width - 1);
+	rect_out->y1 = (i16)(viewport->height - 1);
+	return true;
+}
 
-	ui16 x = 0, y = 0;
-	float3_t coord = { 0 };
-	ijkConsoleColor color = ijkConsoleColor_black;
 
-	sViewport viewport;
-	fViewportInit(&viewport, width, height, viewHeight, viewDist);
+// Test if any listed shape other than one has bounds touching block
+ijk_inl bool fCullIsListTouching(sCull const* const cull, sScene const* const scene, sShapeRef const* const shape, ui32 const count, sRect const* const block, ui32 const type, ui32 const index)
+{
+	sRect const* rect;
+	ui32 i;
+	for (i = 0; i < count; ++i)
+	{
+		if (shape[i].type == type && shape[i].index == index)
+			continue;
+		rect = cull->rect + (shape[i].type == shape_sphere ? 0 : scene->numSpheres) + shape[i].index;
+		if (rect->x0 <= block->x1 && rect->x1 >= block->x0 && rect->y0 <= block->y1 && rect->y1 >= block->y0)
+			return true;
+	}
+	return false;
+}
 
-	sScene scene;
-	fSceneInit(&scene);
+// Test if any shape other than one has bounds touching block in viewport
+//	-> shape is whatever covers the block's corners (none for background); 
+//		a convex shape covering every corner covers the block, so if 
+//		nothing else can touch it, every pixel in the block sees that shape
+//	-> with bins only the block's tiles are searched, otherwise every shape
+ijk_inl bool fCullIsBlockContested(sCull const* const cull, sScene const* const scene, sRect const* const block, ui32 const type, ui32 const index)
+{
+	ui32 tile;
+	i16 tx, ty;
+	if (cull->mode != cull_bins && cull->mode != cull_sortedBins)
+		return fCullIsListTouching(cull, scene, cull->shape, cull->shapes, block, type, index);
+	for (ty = block->y0 / cull_tileSize; ty <= block->y1 / cull_tileSize; ++ty)
+	{
+		for (tx = block->x0 / cull_tileSize; tx <= block->x1 / cull_tileSize; ++tx)
+		{
+			tile = (ui32)ty * (ui32)cull->tilesX + (ui32)tx;
+			if (fCullIsListTouching(cull, scene, cull->bin + cull->offset[tile], cull->offset[tile + 1] - cull->offset[tile], block, type, index))
+				return true;
+		}
+	}
+	return false;
+}
 
-	sRay ray;
 
-	//------------------------------------
-	do
+//-----------------------------------------------------------------------------
+// TRAVERSAL ORDER
+
+// Orders in which pixels (and adaptive blocks) are visited
+//	-> space-filling curves keep consecutive rays near each other on screen 
+//		in both directions, so they share tile lists and shape data; frame 
+//		buffers are still written in row-major order, only visited in turn
+typedef enum eOrder_t
+{
+	order_row,					// Row by row, left to right
+	order_morton,				// Morton (Z) curve, quadrant by quadrant
+	order_hilbert,				// Hilbert curve, each step to a neighbor
+	order_count
+} eOrder;
+
+// Traversal order descriptor
+//	-> lists hold row-major indices in the order they are visited; blocks 
+//		are the starting blocks of adaptive sampling
+typedef struct sOrder_t
+{
+	eOrder mode;				// Order of current lists
+	ui16 width, height;			// Dimensions of frame in pixels
+	ui16 blockSize;				// Block size of block list
+	ui32* pixel;				// Pixel indices in visiting order
+	ui32* block;				// Block indices in visiting order
+} sOrder;
+
+// Get location on Morton curve of given index
+ijk_inl void fOrderGetMorton(ui32 const d, ui16* const x_out, ui16* const y_out)
+{
+	ui32 x = 0, y = 0, b;
+	for (b = 0; b < 16; ++b)
 	{
-		//ijkConsoleDrawTestPatch();
-		ijkConsoleClear();
-		for (y = 0; y < height; ++y)
+		x |= ((d >> (2 * b + 0)) & 1) << b;
+		y |= ((d >> (2 * b + 1)) & 1) << b;
+	}
+	*x_out = (ui16)x;
+	*y_out = (ui16)y;
+}
+
+// Get location on Hilbert curve of given index, covering square of given 
+//	size (power of two)
+ijk_inl void fOrderGetHilbert(ui32 const size, ui32 const d, ui16* const x_out, ui16* const y_out)
+{
+	ui32 x = 0, y = 0, t = d, s, rx, ry, swap;
+	for (s = 1; s < size; s *= 2)
+	{
+		rx = 1 & (t / 2);
+		ry = 1 & (t ^ rx);
+		if (ry == 0)
 		{
-			//color = (ijkConsoleColor)(y % 16); // test rows
-			for (x = 0; x < width; ++x)
+			// rotate quadrant
+			if (rx == 1)
 			{
-				fViewportGetViewCoord(&viewport, coord, x, y);
-				fRayInitPersp(&ray, vec3f0.v, coord);
-				fRayCalcColor(&ray, &scene, &color);
-				//color = (ijkConsoleColor)(((x % 16) + y) % 16); // test pattern
-				ijkConsoleDrawPixel(console, color, x, y);
+				x = s - 1 - x;
+				y = s - 1 - y;
 			}
+			swap = x;
+			x = y;
+			y = swap;
 		}
-		ijkConsoleDrawPixel(console, ijkConsoleColor_black, x, y);
-	} while (!getchar());
-	//------------------------------------
-
-	return ijk_success;
+		x += s * rx;
+		y += s * ry;
+		t /= 4;
+	}
+	*x_out = (ui16)x;
+	*y_out = (ui16)y;
 }
 
+// Build list of row-major indices of grid in traversal order
+//	-> curves cover the smallest power-of-two square around the grid and 
+//		skip locations outside of it
+ijk_inl void fOrderBuild(ui32* const index_out, eOrder const mode, ui16 const width, ui16 const height)
+{
+	ui32 size, d, k;
+	ui16 x, y;
 
-//-----------------------------------------------------------------------------
+	if (mode == order_row)
+	{
+		for (k = 0; k < (ui32)width * (ui32)height; ++k)
+			index_out[k] = k;
+		return;
+	}
+	for (size = 1; size < width || size < height; size *= 2);
+	for (d = 0, k = 0; d < size * size; ++d)
+	{
+		if (mode == order_morton)
+			fOrderGetMorton(d, &x, &y);
+		else
+			fOrderGetHilbert(size, d, &x, &y);
+		if (x < width && y < height)
+			index_out[k++] = (ui32)y * (ui32)width + (ui32)x;
+	}
+}
 
-iret ijkPlayerMain()
+// Allocate traversal lists for frame dimensions
+ijk_inl bool fOrderCreate(sOrder* const order, ui16 const width, ui16 const height)
 {
-	iret status = -1;
-	i32 i = -1;
+	if (!order || !width || !height || order->pixel || order->block)
+		return false;
 
-	// data structures for management
-	ijkConsole console[1] = { 0 };
+	size_t const count = (size_t)width * (size_t)height;
+	order->pixel = (ui32*)malloc(count * sizeof(*order->pixel));
+	order->block = (ui32*)malloc(count * sizeof(*order->block));
+	if (!order->pixel || !order->block)
+	{
+		free(order->pixel);
+		free(order->block);
+		order->pixel = order->block = 0;
+		return false;
+	}
+	order->mode = order_count;
+	order->width = width;
+	order->height = height;
+	order->blockSize = 0;
+	return true;
+}
+
+// Release traversal lists
+ijk_inl bool fOrderRelease(sOrder* const order)
+{
+	if (!order)
+		return false;
+
+	free(order->pixel);
+	free(order->block);
+	order->pixel = order->block = 0;
+	order->width = order->height = order->blockSize = 0;
+	return true;
+}
+
+// Rebuild traversal lists if mode or block size changed
+ijk_inl bool fOrderUpdate(sOrder* const order, eOrder const mode, ui16 const blockSize)
+{
+	if (!order || !order->pixel || mode >= order_count || !blockSize)
+		return false;
+
+	if (mode != order->mode)
+		fOrderBuild(order->pixel, mode, order->width, order->height);
+	if (mode != order->mode || blockSize != order->blockSize)
+		fOrderBuild(order->block, mode, (order->width + blockSize - 1) / blockSize, (order->height + blockSize - 1) / blockSize);
+	order->mode = mode;
+	order->blockSize = blockSize;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// DISPLAY
+
+// Ray hit record
+//	-> NOTE: 'dist' is the ray parameter at the hit, measured in lengths of 
+//		the ray's direction (not normalized); 'type' is shape_none on a miss
+typedef struct sRecord_t
+{
+	ui32 type, index;
+	float_t dist;
+} sRecord;
+
+// Test if two hit records are on the same shape (or both missed)
+ijk_inl bool fRecordIsSameShape(sRecord const* const hit_lh, sRecord const* const hit_rh)
+{
+	return (hit_lh->type == hit_rh->type && (hit_lh->type == shape_none || hit_lh->index == hit_rh->index));
+}
+
+// Get color ramp of shape hit by record
+ijk_inl bool fRecordGetColor(sRecord const* const hit, sScene const* const scene, sColor* const color_out)
+{
+	switch (hit->type)
+	{
+	case shape_sphere:
+		fSphereGetColor(scene, hit->index, color_out);
+		return true;
+	case shape_cylinder:
+		fCylinderGetColor(scene, hit->index, color_out);
+		return true;
+	}
+	return false;
+}
+
+// Test ray against sphere
+ijk_inl bool fRayTestSphere(sRay const* const ray, sScene const* const scene, ui32 const shapeIndex, sRecord* const hit_out)
+{
+	assert(shapeIndex < scene->numSpheres);
+	counters_add(counter_testsSphere, 1);
+	if (!fShapeSolveSphere(scene, shapeIndex, ray->origin.v, ray->direction.v, &hit_out->dist))
+		return false;
+
+	hit_out->type = shape_sphere;
+	hit_out->index = shapeIndex;
+	counters_add(counter_hits, 1);
+	return true;
+}
+
+// Test ray against finite cylinder
+ijk_inl bool fRayTestCylinderFinite(sRay const* const ray, sScene const* const scene, ui32 const shapeIndex, sRecord* const hit_out)
+{
+	assert(shapeIndex < scene->numCylinders);
+	counters_add(counter_testsCylinder, 1);
+	if (!fShapeSolveCylinder(scene, shapeIndex, ray->origin.v, ray->direction.v, &hit_out->dist))
+		return false;
+
+	hit_out->type = shape_cylinder;
+	hit_out->index = shapeIndex;
+	counters_add(counter_hits, 1);
+	return true;
+}
+
+// Test ray against any shape by type
+ijk_inl bool fRayTestShape(sRay const* const ray, sScene const* const scene, ui32 const shapeType, ui32 const shapeIndex, sRecord* const hit_out)
+{
+	switch (shapeType)
+	{
+	case shape_sphere:
+		return fRayTestSphere(ray, scene, shapeIndex, hit_out);
+	case shape_cylinder:
+		return fRayTestCylinderFinite(ray, scene, shapeIndex, hit_out);
+	}
+	return false;
+}
+
+// Test ray against list of shapes, keeping closest hit
+//	-> if list is sorted front to back, stops once the closest hit is nearer 
+//		than the next shape can be (compared squared, in scene units)
+//	-> returns number of shapes tested
+ijk_inl ui32 fRayTestClosest(sRay const* const ray, sScene const* const scene, sShapeRef const* const shape, ui32 const count, sRecord* const hit_out)
+{
+	sRecord hit;
+	ui32 i;
+	float_t const lenSq = vec3fLenSq(ray->direction.v);
+
+	hit_out->type = shape_none;
+	hit_out->index = 0;
+	hit_out->dist = 0.0f;
+	for (i = 0; i < count; ++i)
+	{
+		if (hit_out->type != shape_none && hit_out->dist * hit_out->dist * lenSq < shape[i].dist * shape[i].dist)
+			break;
+		if (fRayTestShape(ray, scene, shape[i].type, shape[i].index, &hit) && (hit_out->type == shape_none || hit.dist < hit_out->dist))
+			*hit_out = hit;
+	}
+	return i;
+}
+
+// Test ray against list of shapes, keeping closest hit and the distance of 
+//	the closest hit on any other shape (zero if there is none)
+//	-> if list is sorted, stops once both hits are nearer than the next shape
+//	-> returns number of shapes tested
+ijk_inl ui32 fRayTestClosestNext(sRay const* const ray, sScene const* const scene, sShapeRef const* const shape, ui32 const count, sRecord* const hit_out, float_t* const distNext_out)
+{
+	sRecord hit;
+	ui32 i;
+	float_t distNext = 0.0f;
+	float_t const lenSq = vec3fLenSq(ray->direction.v);
+
+	hit_out->type = shape_none;
+	hit_out->index = 0;
+	hit_out->dist = 0.0f;
+	for (i = 0; i < count; ++i)
+	{
+		if (distNext > 0.0f && distNext * distNext * lenSq < shape[i].dist * shape[i].dist)
+			break;
+		if (!fRayTestShape(ray, scene, shape[i].type, shape[i].index, &hit))
+			continue;
+		if (hit_out->type == shape_none || hit.dist < hit_out->dist)
+		{
+			if (hit_out->type != shape_none)
+				distNext = hit_out->dist;
+			*hit_out = hit;
+		}
+		else if (distNext <= 0.0f || hit.dist < distNext)
+			distNext = hit.dist;
+	}
+	*distNext_out = distNext;
+	return i;
+}
+
+// Test ray against list of shapes for a hit nearer than one already found, 
+//	which is replaced; the shape already hit is skipped
+//	-> a tie goes to whichever shape is listed first, as in a closest-hit 
+//		search of the whole list
+//	-> if list is sorted front to back, stops once the hit is nearer than 
+//		the next shape can be
+//	-> returns number of shapes tested
+ijk_inl ui32 fRayTestNearer(sRay const* const ray, sScene const* const scene, sShapeRef const* const shape, ui32 const count, sRecord* const hit_inout)
+{
+	sRecord hit;
+	ui32 i;
+	bool listed = false;
+	float_t const lenSq = vec3fLenSq(ray->direction.v);
+	for (i = 0; i < count; ++i)
+	{
+		if (hit_inout->dist * hit_inout->dist * lenSq < shape[i].dist * shape[i].dist)
+			break;
+		if (!listed && shape[i].type == hit_inout->type && shape[i].index == hit_inout->index)
+		{
+			listed = true;
+			continue;
+		}
+		if (fRayTestShape(ray, scene, shape[i].type, shape[i].index, &hit) &&
+			(hit.dist < hit_inout->dist || (hit.dist == hit_inout->dist && !listed)))
+		{
+			*hit_inout = hit;
+			listed = true;
+		}
+	}
+	return i;
+}
+
+// Test ray against all shapes for any hit before a distance (shadow rays)
+ijk_inl bool fRayTestAny(sRay const* const ray, sScene const* const scene, float_t const distMax)
+{
+	sRecord hit;
+	ui32 i;
+	counters_add(counter_shadowRays, 1);
+	for (i = 0; i < scene->numSpheres; ++i)
+		if (fRayTestSphere(ray, scene, i, &hit) && hit.dist < distMax)
+			return true;
+	for (i = 0; i < scene->numCylinders; ++i)
+		if (fRayTestCylinderFinite(ray, scene, i, &hit) && hit.dist < distMax)
+			return true;
+	return false;
+}
+
+// Calculate hit point, unit surface normal and color ramp from hit record
+ijk_inl bool fRecordGetSurface(sRecord const* const hit, sRay const* const ray, sScene const* const scene, vec3f* const point_out, vec3f* const normal_out, sColor* const color_out)
+{
+	vec3fMad(point_out->v, ray->origin.v, ray->direction.v, hit->dist);
+	return (fRecordGetColor(hit, scene, color_out) &&
+		fShapeGetNormal(scene, hit->type, hit->index, point_out->v, normal_out->v));
+}
+
+// Calculate shaded color of hit record, also storing Lambertian coefficient
+//	-> Lambertian coefficient from the point light picks light or dark 
+//		entry of the shape's color ramp; a shadow ray towards the light 
+//		forces dark if anything is in the way; misses get background
+//	-> shading uses the fast math tier; intersections stay precise
+ijk_inl ijkConsoleColor fRecordCalcShade(sRecord const* const hit, sRay const* const ray, sScene const* const scene, float_t* const lambert_out)
+{
+	vec3f point, normal, light;
+	sColor color;
+	sRay shadow;
+
+	*lambert_out = 0.0f;
+	if (!fRecordGetSurface(hit, ray, scene, &point, &normal, &color))
+		return scene->color_bg;
+
+	fPointLightGet(scene, 0, &light);
+	float_t const lambert = *lambert_out = fShapeCalcLambert(point.v, normal.v, light.v, shadow.direction.v);
+	if (lambert <= shade_lambertLight)
+		return color.color[0];
+
+	shadow.origin = point;
+	return color.color[!fRayTestAny(&shadow, scene, 1.0f)];
+}
+
+// Calculate shaded color of hit record
+ijk_inl ijkConsoleColor fRecordCalcColor(sRecord const* const hit, sRay const* const ray, sScene const* const scene)
+{
+	float_t lambert;
+	return fRecordCalcShade(hit, ray, scene, &lambert);
+}
+
+// Calculate final color from ray in scene, testing a list of shapes
+//	-> closest hit is also stored (if requested) for reuse by later frames
+//	-> shadow rays still test every shape, since the list only covers 
+//		shapes that can be seen
+//	-> returns number of shapes tested
+ijk_inl ui32 fRayCalcColor(sRay const* const ray, sScene const* const scene, sShapeRef const* const shape, ui32 const count, ijkConsoleColor* const color_out, sRecord* const hit_out)
+{
+	sRecord hit;
+	ui32 const tests = fRayTestClosest(ray, scene, shape, count, &hit);
+	*color_out = fRecordCalcColor(&hit, ray, scene);
+	if (hit_out)
+		*hit_out = hit;
+	return tests;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// Frame descriptor
+//	-> stores the color and closest primary hit per pixel, as well as the 
+//		camera used, so the next frame can reproject instead of re-tracing
+typedef struct sFrame_t
+{
+	sCamera camera;				// Camera used to render frame
+	ui16 width, height;			// Dimensions of frame in pixels
+	ijkConsoleColor* color;		// Final color per pixel (row-major)
+	sRecord* record;			// Closest primary hit per pixel (row-major)
+	byte* flag;					// Scratch state per pixel used while rendering
+} sFrame;
+
+// Wavefront stages
+typedef enum eWave_t
+{
+	wave_generate,				// Queue primary ray for every pixel
+	wave_intersect,				// Test queue against one shape at a time
+	wave_compact,				// Queue hits for shading, emit shadow rays
+	wave_shade,					// Trace shadow rays and resolve colors
+	wave_count
+} eWave;
+
+// Frame statistics
+typedef struct sFrameStats_t
+{
+	ui32 pixels;				// Total pixels in frame
+	ui32 rays;					// Primary rays tested against all shapes
+	ui32 reused;				// Reprojected pixels confirmed by verification ray
+	ui32 rejected;				// Reprojected pixels whose verification ray missed
+	ui32 disoccluded;			// Pixels that received no reprojected sample
+	ui32 edges;					// Pixels anti-aliased for being on a shape edge
+	ui32 samples;				// Extra anti-aliasing rays
+	ui32 rasterized;			// Pixels covered by rasterized sphere spans
+	ui32 fallback;				// Stepped sphere tests re-solved near a silhouette
+	ui32 switches;				// Consecutive primary rays in different culling tiles
+	f64 msStage[wave_count];	// Time per wavefront stage in milliseconds
+	ui64 tests;					// Primary ray tests against shapes
+	ui64 testsAll;				// Primary ray tests if every ray tested every shape
+} sFrameStats;
+
+// Reset frame statistics
+ijk_inl void fFrameStatsReset(sFrameStats* const stats, ui32 const pixels)
+{
+	sFrameStats const reset = { pixels };
+	*stats = reset;
+}
+
+// Adaptive sampling pixel states
+enum
+{
+	flag_empty,					// Pixel not written yet
+	flag_filled,				// Pixel filled from uniform block corners
+	flag_sampled,				// Pixel traced
+	flag_sampledNear,			// Pixel traced, close to changing shape or shading
+	flag_edge,					// Pixel is next to a different shape
+};
+
+// Relative depth gap under which a shape behind the closest hit is near 
+//	enough that the two may cross (and swap) between adaptive samples
+#define adaptive_gapNear 0.1f
+
+// Distance of Lambertian coefficient from light threshold under which 
+//	shading may change between adaptive samples
+#define adaptive_lambertNear 0.1f
+
+// Allocate frame buffers
+ijk_inl bool fFrameCreate(sFrame* const frame, ui16 const width, ui16 const height)
+{
+	if (!frame || !width || !height || frame->color || frame->record || frame->flag)
+		return false;
+
+	size_t const count = (size_t)width * (size_t)height;
+	frame->color = (ijkConsoleColor*)malloc(count * sizeof(*frame->color));
+	frame->record = (sRecord*)malloc(count * sizeof(*frame->record));
+	frame->flag = (byte*)malloc(count * sizeof(*frame->flag));
+	if (!frame->color || !frame->record || !frame->flag)
+	{
+		free(frame->color);
+		free(frame->record);
+		free(frame->flag);
+		frame->color = 0;
+		frame->record = 0;
+		frame->flag = 0;
+		return false;
+	}
+	frame->width = width;
+	frame->height = height;
+	return true;
+}
+
+// Release frame buffers
+ijk_inl bool fFrameRelease(sFrame* const frame)
+{
+	if (!frame)
+		return false;
+
+	free(frame->color);
+	free(frame->record);
+	free(frame->flag);
+	frame->color = 0;
+	frame->record = 0;
+	frame->flag = 0;
+	frame->width = frame->height = 0;
+	return true;
+}
+
+// Trace every pixel of frame from scratch, visiting pixels in order
+//	-> counts how often consecutive rays land in different culling tiles, 
+//		which need a different shape list and its data
+ijk_inl void fFrameTrace(sFrame* const frame, sOrder const* const order, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sFrameStats* const stats_out)
+{
+	sRay ray;
+	sShapeRef const* shape;
+	ui16 x, y;
+	ui32 i, k, count, tile, tile_prev;
+
+	fFrameStatsReset(stats_out, (ui32)frame->width * (ui32)frame->height);
+	stats_out->rays = stats_out->disoccluded = stats_out->pixels;
+	frame->camera = *camera;
+	for (k = 0, tile_prev = 0; k < stats_out->pixels; ++k, tile_prev = tile)
+	{
+		i = order->pixel[k];
+		x = (ui16)(i % frame->width);
+		y = (ui16)(i / frame->width);
+		tile = (ui32)(y / cull_tileSize) * (ui32)cull->tilesX + (ui32)(x / cull_tileSize);
+		stats_out->switches += (k > 0 && tile != tile_prev);
+		fRayInitPrimary(&ray, viewport, camera, x, y);
+		shape = fCullGetList(cull, x, y, &count);
+		stats_out->tests += fRayCalcColor(&ray, scene, shape, count, frame->color + i, frame->record + i);
+	}
+	stats_out->testsAll = (ui64)stats_out->rays * (ui64)cull->shapes;
+}
+
+// Render frame by reprojecting previous frame into new camera
+//	-> each hit in the previous frame is moved into the scene using its 
+//		stored distance, then projected into the new view; closest sample 
+//		per pixel wins; a verification ray tests the reprojected shape, 
+//		then the pixel's list for any shape nearer than that hit (sorted 
+//		lists stop at once past it): if the closest shape is still the 
+//		reprojected one the pixel is only shaded, otherwise it takes the 
+//		nearer hit and counts as rejected, as does a pixel whose shape is 
+//		missed and is traced
+//	-> previous hits next to a different shape (or a miss) are not moved, 
+//		so pixels along silhouettes and intersections are always traced
+//	-> misses (background) cannot be reprojected since they have no depth
+ijk_inl void fFrameReproject(sFrame* const frame, sFrame const* const frame_prev, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sFrameStats* const stats_out)
+{
+	sRay ray;
+	sRecord hit;
+	sShapeRef const* shape;
+	ui32 count_shape;
+	vec3f point, point_eye;
+	float_t depth;
+	ui16 x, y, x_curr, y_curr;
+	ui32 i, j;
+	ui32 const width = frame->width, count = (ui32)frame->width * (ui32)frame->height;
+
+	fFrameStatsReset(stats_out, count);
+
+	// same view: everything is still valid
+	if (fCameraIsEqual(&frame_prev->camera, camera))
+	{
+		frame->camera = *camera;
+		for (i = 0; i < count; ++i)
+		{
+			frame->color[i] = frame_prev->color[i];
+			frame->record[i] = frame_prev->record[i];
+		}
+		stats_out->reused = count;
+		return;
+	}
+
+	// clear to no sample
+	frame->camera = *camera;
+	for (i = 0; i < count; ++i)
+		frame->record[i].type = shape_none;
+
+	// scatter previous hits into new view, keeping closest
+	//	-> for the new primary ray, ray parameter is eye depth over view distance
+	for (y = 0, i = 0; y < frame_prev->height; ++y)
+	{
+		for (x = 0; x < frame_prev->width; ++x, ++i)
+		{
+			hit = frame_prev->record[i];
+			if (hit.type == shape_none ||
+				(x > 0 && !fRecordIsSameShape(&hit, frame_prev->record + i - 1)) ||
+				(x + 1 < frame_prev->width && !fRecordIsSameShape(&hit, frame_prev->record + i + 1)) ||
+				(y > 0 && !fRecordIsSameShape(&hit, frame_prev->record + i - width)) ||
+				(y + 1 < frame_prev->height && !fRecordIsSameShape(&hit, frame_prev->record + i + width)))
+				continue;
+
+			fRayInitPrimary(&ray, viewport, &frame_prev->camera, x, y);
+			vec3fMad(point.v, ray.origin.v, ray.direction.v, hit.dist);
+			fCameraTransformToEye(camera, point_eye.v, point.v);
+			depth = -point_eye.z;
+			if (depth <= epsf)
+				continue;
+
+			vec3fMul(point_eye.v, point_eye.v, viewport->viewDist / depth);
+			if (!fViewportGetPixel(viewport, point_eye.v, &x_curr, &y_curr))
+				continue;
+
+			j = (ui32)y_curr * width + (ui32)x_curr;
+			depth /= viewport->viewDist;
+			if (frame->record[j].type == shape_none || depth < frame->record[j].dist)
+			{
+				frame->record[j] = hit;
+				frame->record[j].dist = depth;
+			}
+		}
+	}
+
+	// verify samples against their own shape only; trace the rest
+	for (y = 0, i = 0; y < frame->height; ++y)
+	{
+		for (x = 0; x < frame->width; ++x, ++i)
+		{
+			fRayInitPrimary(&ray, viewport, camera, x, y);
+			hit = frame->record[i];
+			shape = fCullGetList(cull, x, y, &count_shape);
+			if (hit.type != shape_none)
+			{
+				++stats_out->tests;
+				++stats_out->testsAll;
+				if (fRayTestShape(&ray, scene, hit.type, hit.index, &hit))
+				{
+					// a nearer shape means the IDs disagree: keep its hit
+					stats_out->tests += fRayTestNearer(&ray, scene, shape, count_shape, &hit);
+					stats_out->testsAll += cull->shapes;
+					if (fRecordIsSameShape(&hit, frame->record + i))
+						++stats_out->reused;
+					else
+					{
+						++stats_out->rejected;
+						++stats_out->rays;
+					}
+					frame->color[i] = fRecordCalcColor(&hit, &ray, scene);
+					frame->record[i] = hit;
+					continue;
+				}
+				++stats_out->rejected;
+			}
+			else
+				++stats_out->disoccluded;
+			stats_out->tests += fRayCalcColor(&ray, scene, shape, count_shape, frame->color + i, frame->record + i);
+			stats_out->testsAll += cull->shapes;
+			++stats_out->rays;
+		}
+	}
+}
+
+// Rasterize sphere into closest hits of frame, span by span
+//	-> seen in perspective, a sphere covers a conic in the viewport: along 
+//		a row, the discriminant of the ray-sphere quadratic is itself a 
+//		quadratic in the view coord's x, so the row's span lies between its 
+//		roots; depth is only solved for pixels in the span
+//	-> spans are padded by a pixel and each pixel checks its own 
+//		discriminant, so rounding at the silhouette cannot drop pixels
+//	-> returns number of pixels whose depth was solved
+ijk_inl ui32 fFrameRasterSphere(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCamera const* const camera, ui32 const shapeIndex)
+{
+	sShapeRef const shape = { shape_sphere, shapeIndex };
+	float3_t center, extent, coord;
+	sRect rect;
+	i16 x, y, x0, x1;
+	ui32 i, count = 0;
+
+	if (!fShapeGetBoundsEye(scene, camera, &shape, center, extent) ||
+		!fViewportGetBounds(viewport, center, extent, &rect))
+		return 0;
+
+	// viewer outside of sphere if positive, in which case spans are bounded
+	float_t const k = vec3fLenSq(center) - extent[0] * extent[0];
+	float_t const columnWidth = viewport->viewWidth * viewport->widthInv;
+	for (y = rect.y0; y <= rect.y1; ++y)
+	{
+		// ray direction is (X, Y, -viewDist) where X is linear in column
+		fViewportGetViewCoord(viewport, coord, 0, y);
+		float_t const e = coord[1] * center[1] + coord[2] * center[2];
+		float_t const f = coord[1] * coord[1] + coord[2] * coord[2];
+		x0 = rect.x0;
+		x1 = rect.x1;
+		if (k > 0.0f)
+		{
+			// discriminant: A*X^2 + B*X + C; span is between roots if A < 0
+			float_t const A = center[0] * center[0] - k, B = 2.0f * center[0] * e, C = e * e - f * k;
+			if (A < 0.0f)
+			{
+				float_t const q = B * B - 4.0f * A * C;
+				if (q < 0.0f)
+					continue;
+
+				float_t const root = fSqrt(q), aInv = 0.5f / A;
+				float_t const xa = ((-B + root) * aInv - coord[0]) / columnWidth;
+				float_t const xb = ((-B - root) * aInv - coord[0]) / columnWidth;
+				if (xa > (float_t)x1 || xb < (float_t)x0)
+					continue;
+				if (xa > (float_t)x0)
+					x0 = (i16)xa;
+				if (xb + 1.0f < (float_t)x1)
+					x1 = (i16)xb + 1;
+			}
+		}
+
+		// solve depth per pixel, same as a ray test from the viewer
+		for (x = x0, i = (ui32)y * (ui32)frame->width + (ui32)x0; x <= x1; ++x, ++i)
+		{
+			fViewportGetViewCoord(viewport, coord, x, y);
+			float_t const a = coord[0] * coord[0] + f;
+			float_t const b = -(coord[0] * center[0] + e);
+			float_t const disc = b * b - a * k;
+			++count;
+			if (disc < 0.0f)
+				continue;
+
+			float_t const root = fSqrt(disc), aInv = 1.0f / a;
+			float_t dist = (-b - root) * aInv;
+			if (dist < ray_distMin)
+			{
+				dist = (-b + root) * aInv;
+				if (dist < ray_distMin)
+					continue;
+			}
+
+			sRecord* const hit = frame->record + i;
+			if (hit->type == shape_none || dist < hit->dist)
+			{
+				hit->type = shape_sphere;
+				hit->index = shapeIndex;
+				hit->dist = dist;
+			}
+		}
+	}
+	return count;
+}
+
+// Render frame by rasterizing spheres and tracing the rest
+//	-> spheres are rasterized into the frame's closest hits first; each 
+//		pixel then tests its primary ray against the remaining shapes 
+//		(cylinders) and is shaded from whichever hit is closer; shading 
+//		still traces shadow rays
+ijk_inl void fFrameRaster(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sFrameStats* const stats_out)
+{
+	sRay ray;
+	sRecord hit;
+	sShapeRef const* shape;
+	ui16 x, y;
+	ui32 i, j, count;
+	bool traced;
+
+	fFrameStatsReset(stats_out, (ui32)frame->width * (ui32)frame->height);
+	stats_out->testsAll = (ui64)stats_out->pixels * (ui64)cull->shapes;
+	frame->camera = *camera;
+	for (i = 0; i < stats_out->pixels; ++i)
+	{
+		frame->record[i].type = shape_none;
+		frame->record[i].index = 0;
+		frame->record[i].dist = 0.0f;
+	}
+	for (i = 0; i < scene->numSpheres; ++i)
+		stats_out->tests += fFrameRasterSphere(frame, viewport, scene, camera, i);
+
+	for (y = 0, i = 0; y < frame->height; ++y)
+	{
+		for (x = 0; x < frame->width; ++x, ++i)
+		{
+			stats_out->rasterized += (frame->record[i].type != shape_none);
+			fRayInitPrimary(&ray, viewport, camera, x, y);
+			shape = fCullGetList(cull, x, y, &count);
+			for (j = 0, traced = false; j < count; ++j)
+			{
+				if (shape[j].type == shape_sphere)
+					continue;
+				if (fRayTestShape(&ray, scene, shape[j].type, shape[j].index, &hit) &&
+					(frame->record[i].type == shape_none || hit.dist < frame->record[i].dist))
+					frame->record[i] = hit;
+				++stats_out->tests;
+				traced = true;
+			}
+			stats_out->rays += traced;
+			frame->color[i] = fRecordCalcColor(frame->record + i, &ray, scene);
+		}
+	}
+}
+
+// Sphere test stepped along a row of primary rays
+//	-> along a row, ray direction changes by a constant step per pixel, so 
+//		the half-b coefficient is linear and the discriminant and squared 
+//		direction length are quadratic in the column; each is advanced by 
+//		forward differences, making a miss a few adds and a compare
+typedef struct sScanSphere_t
+{
+	float_t b, db;				// Half-b coefficient and its step
+	float_t a, da, dda;			// Squared direction length and its steps
+	float_t disc, ddisc, dddisc;	// Discriminant and its steps
+	float_t c;					// Constant coefficient
+} sScanSphere;
+
+// Columns stepped before the sphere test is restarted from an exact ray
+#define scanline_span 16
+
+// Discriminant relative to its terms under which the stepped value is too 
+//	close to zero to trust, so the test falls back to a full solve
+#define scanline_discNear 0.001f
+
+// Start stepped sphere test from ray, given change in direction per column
+ijk_inl void fScanSphereInit(sScanSphere* const scan, sRay const* const ray, float3_t const step, sScene const* const scene, ui32 const shapeIndex)
+{
+	vec3f location, diff;
+	float_t radius;
+	fSphereGet(scene, shapeIndex, &location, &radius);
+	vec3fSub(diff.v, ray->origin.v, location.v);
+
+	// b(u) = b + u*db; a(u) = a + 2u*ad + u^2*ss; disc(u) = b(u)^2 - a(u)*c
+	float_t const b = vec3fDot(ray->direction.v, diff.v), db = vec3fDot(step, diff.v);
+	float_t const a = vec3fLenSq(ray->direction.v), ad = vec3fDot(ray->direction.v, step), ss = vec3fLenSq(step);
+	float_t const c = vec3fLenSq(diff.v) - radius * radius;
+	float_t const p2 = db * db - c * ss, p1 = 2.0f * (b * db - c * ad);
+	scan->b = b;
+	scan->db = db;
+	scan->a = a;
+	scan->da = 2.0f * ad + ss;
+	scan->dda = 2.0f * ss;
+	scan->disc = b * b - a * c;
+	scan->ddisc = p2 + p1;
+	scan->dddisc = 2.0f * p2;
+	scan->c = c;
+}
+
+// Step sphere test to next column
+ijk_inl void fScanSphereStep(sScanSphere* const scan)
+{
+	scan->b += scan->db;
+	scan->a += scan->da;
+	scan->da += scan->dda;
+	scan->disc += scan->ddisc;
+	scan->ddisc += scan->dddisc;
+}
+
+// Render frame by stepping sphere tests along rows and tracing the rest
+//	-> each sphere is stepped with forward differences over the rows and 
+//		columns of its projected bounds only, restarted from an exact ray 
+//		every few columns to bound drift; a discriminant near zero is 
+//		re-tested with the full sphere test; other shapes (cylinders) are 
+//		ray tested per pixel
+ijk_inl void fFrameScanline(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sFrameStats* const stats_out)
+{
+	float3_t const step_eye = { viewport->viewWidth * viewport->widthInv, 0.0f, 0.0f };
+	float3_t step, center, extent;
+	sScanSphere scan;
+	sRay ray;
+	sRecord hit;
+	sRect rect;
+	sShapeRef const* shape;
+	i16 x, y, x0, x1;
+	ui32 i, j, s, count;
+	bool traced;
+
+	fFrameStatsReset(stats_out, (ui32)frame->width * (ui32)frame->height);
+	stats_out->testsAll = (ui64)stats_out->pixels * (ui64)cull->shapes;
+	frame->camera = *camera;
+	fCameraRotateToScene(camera, step, step_eye);
+	for (i = 0; i < stats_out->pixels; ++i)
+	{
+		frame->record[i].type = shape_none;
+		frame->record[i].index = 0;
+		frame->record[i].dist = 0.0f;
+	}
+
+	// spheres: step along each row of bounds
+	for (s = 0; s < scene->numSpheres; ++s)
+	{
+		sShapeRef const sphere = { shape_sphere, s };
+		if (!fShapeGetBoundsEye(scene, camera, &sphere, center, extent) ||
+			!fViewportGetBounds(viewport, center, extent, &rect))
+			continue;
+		for (y = rect.y0; y <= rect.y1; ++y)
+		{
+			sRecord* const row = frame->record + (ui32)y * (ui32)frame->width;
+			for (x0 = rect.x0; x0 <= rect.x1; x0 = x1)
+			{
+				x1 = ijk_minimum(x0 + scanline_span, rect.x1 + 1);
+				fRayInitPrimary(&ray, viewport, camera, x0, y);
+				fScanSphereInit(&scan, &ray, step, scene, s);
+				for (x = x0; x < x1; ++x, fScanSphereStep(&scan))
+				{
+					float_t const ac = scan.a * scan.c;
+					float_t const near = scanline_discNear * (scan.b * scan.b + (ac < 0.0f ? -ac : ac));
+					++stats_out->tests;
+					counters_add(counter_testsSphere, 1);
+					if (scan.disc < -near)
+						continue;
+					if (scan.disc <= near)
+					{
+						++stats_out->fallback;
+						fRayInitPrimary(&ray, viewport, camera, x, y);
+						if (!fRayTestSphere(&ray, scene, s, &hit))
+							continue;
+					}
+					else
+					{
+						float_t const root = fSqrt(scan.disc), aInv = 1.0f / scan.a;
+						hit.dist = (-scan.b - root) * aInv;
+						if (hit.dist < ray_distMin)
+						{
+							hit.dist = (-scan.b + root) * aInv;
+							if (hit.dist < ray_distMin)
+								continue;
+						}
+						hit.type = shape_sphere;
+						hit.index = s;
+						counters_add(counter_hits, 1);
+					}
+					if (row[x].type == shape_none || hit.dist < row[x].dist)
+						row[x] = hit;
+				}
+			}
+		}
+	}
+
+	// everything else: ray test per pixel, then shade
+	for (y = 0, i = 0; y < frame->height; ++y)
+	{
+		for (x = 0; x < frame->width; ++x, ++i)
+		{
+			fRayInitPrimary(&ray, viewport, camera, x, y);
+			shape = fCullGetList(cull, x, y, &count);
+			for (j = 0, traced = false; j < count; ++j)
+			{
+				if (shape[j].type == shape_sphere)
+					continue;
+				if (fRayTestShape(&ray, scene, shape[j].type, shape[j].index, &hit) &&
+					(frame->record[i].type == shape_none || hit.dist < frame->record[i].dist))
+					frame->record[i] = hit;
+				++stats_out->tests;
+				traced = true;
+			}
+			stats_out->rays += traced;
+			frame->color[i] = fRecordCalcColor(frame->record + i, &ray, scene);
+		}
+	}
+}
+
+// Shadow ray queued by wavefront
+typedef struct sWaveShadow_t
+{
+	sRay ray;					// Ray from hit point to light
+	sColor ramp;				// Color ramp of shape hit
+	ui32 pixel;					// Pixel to resolve
+} sWaveShadow;
+
+// Wavefront queues
+//	-> instead of taking each pixel through every step, each stage runs 
+//		over the whole frame's queue before the next one starts, so every 
+//		loop does one kind of work over contiguous arrays; primary rays all 
+//		start at the camera, so only their directions are queued, split by 
+//		axis along with their squared lengths
+typedef struct sWavefront_t
+{
+	ui32 capacity;				// Entries each queue can hold
+	ui32 shades;				// Hits queued for shading
+	ui32 shadows;				// Shadow rays queued
+	float_t* direction[3];		// Primary ray direction per axis
+	float_t* lenSq;				// Primary ray squared direction length
+	ui32* shade;				// Pixels queued for shading
+	sWaveShadow* shadow;		// Shadow rays queued
+	ijkTimer timer[1];			// Stage timer
+} sWavefront;
+
+// Allocate wavefront queues for frame size
+ijk_inl bool fWavefrontCreate(sWavefront* const wave, ui16 const width, ui16 const height)
+{
+	if (!wave || !width || !height || wave->lenSq || !ijk_issuccess(ijkTimerInit(wave->timer)))
+		return false;
+
+	size_t const count = (size_t)width * (size_t)height;
+	wave->direction[0] = (float_t*)malloc(count * sizeof(**wave->direction));
+	wave->direction[1] = (float_t*)malloc(count * sizeof(**wave->direction));
+	wave->direction[2] = (float_t*)malloc(count * sizeof(**wave->direction));
+	wave->lenSq = (float_t*)malloc(count * sizeof(*wave->lenSq));
+	wave->shade = (ui32*)malloc(count * sizeof(*wave->shade));
+	wave->shadow = (sWaveShadow*)malloc(count * sizeof(*wave->shadow));
+	if (!wave->direction[0] || !wave->direction[1] || !wave->direction[2] ||
+		!wave->lenSq || !wave->shade || !wave->shadow)
+	{
+		free(wave->direction[0]);
+		free(wave->direction[1]);
+		free(wave->direction[2]);
+		free(wave->lenSq);
+		free(wave->shade);
+		free(wave->shadow);
+		wave->direction[0] = wave->direction[1] = wave->direction[2] = wave->lenSq = 0;
+		wave->shade = 0;
+		wave->shadow = 0;
+		return false;
+	}
+	wave->capacity = (ui32)count;
+	wave->shades = wave->shadows = 0;
+	return true;
+}
+
+// Release wavefront queues
+ijk_inl bool fWavefrontRelease(sWavefront* const wave)
+{
+	if (!wave)
+		return false;
+
+	free(wave->direction[0]);
+	free(wave->direction[1]);
+	free(wave->direction[2]);
+	free(wave->lenSq);
+	free(wave->shade);
+	free(wave->shadow);
+	wave->direction[0] = wave->direction[1] = wave->direction[2] = wave->lenSq = 0;
+	wave->shade = 0;
+	wave->shadow = 0;
+	wave->capacity = wave->shades = wave->shadows = 0;
+	return true;
+}
+
+// Render frame in wavefront stages
+//	-> generate: queue primary ray direction per pixel
+//	-> intersect: each sphere, then each cylinder, is tested against every 
+//		queued ray within its culling bounds, keeping closest hits
+//	-> compact: hits are packed into a shading queue; surfaces facing away 
+//		from the light resolve to dark, the rest emit a shadow ray
+//	-> shade: shadow rays are traced and their pixels resolved
+ijk_inl void fFrameWavefront(sFrame* const frame, sWavefront* const wave, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sFrameStats* const stats_out)
+{
+	sRay ray;
+	sRecord hit;
+	sRect rect;
+	vec3f location, diff, point, normal, light;
+	float_t radius, c;
+	ui16 x, y;
+	ui32 i, j, s;
+	ui32 const count = (ui32)frame->width * (ui32)frame->height;
+
+	fFrameStatsReset(stats_out, count);
+	if (count > wave->capacity)
+		return;
+	stats_out->rays = count;
+	stats_out->testsAll = (ui64)count * (ui64)cull->shapes;
+	frame->camera = *camera;
+	ijkTimerStart(wave->timer);
+
+	// generate: squared lengths a whole row at a time
+	ijk_zone_begin("raygen");
+	perf_begin(perf_raygen);
+	for (y = 0, i = 0; y < frame->height; ++y)
+	{
+		vec3fStream const row = { wave->direction[0] + i, wave->direction[1] + i, wave->direction[2] + i };
+		floatv_t const row_lenSq = wave->lenSq + i;
+		for (x = 0; x < frame->width; ++x, ++i)
+		{
+			fRayInitPrimary(&ray, viewport, camera, x, y);
+			wave->direction[0][i] = ray.direction.x;
+			wave->direction[1][i] = ray.direction.y;
+			wave->direction[2][i] = ray.direction.z;
+			frame->record[i].type = shape_none;
+			frame->record[i].index = 0;
+			frame->record[i].dist = 0.0f;
+		}
+		vec3fStreamLenSq(row_lenSq, &row, frame->width);
+	}
+	perf_end(perf_raygen);
+	ijk_zone_end();
+	stats_out->msStage[wave_generate] = ijkTimerLap(wave->timer) * 1000.0;
+
+	// intersect: spheres (same math as sphere ray test, origin shared)
+	ijk_zone_begin("intersect");
+	perf_begin(perf_intersect);
+	ray.origin = camera->location;
+	for (s = 0; s < scene->numSpheres; ++s)
+	{
+		if (!fCullGetBounds(cull, viewport, s, &rect))
+			continue;
+		fSphereGet(scene, s, &location, &radius);
+		vec3fSub(diff.v, ray.origin.v, location.v);
+		c = vec3fLenSq(diff.v) - radius * radius;
+		for (y = rect.y0; y <= rect.y1; ++y)
+		{
+			// hits are tallied per row so counting stays out of the test loop
+			ui32 hits = 0;
+			for (x = rect.x0, i = (ui32)y * (ui32)frame->width + (ui32)x; x <= rect.x1; ++x, ++i)
+			{
+				float_t const a = wave->lenSq[i];
+				float_t const b = wave->direction[0][i] * diff.x + wave->direction[1][i] * diff.y + wave->direction[2][i] * diff.z;
+				float_t const disc = b * b - a * c;
+				if (disc < 0.0f || !fIsNonZero(a))
+					continue;
+
+				float_t const root = fSqrt(disc), aInv = 1.0f / a;
+				float_t dist = (-b - root) * aInv;
+				if (dist < ray_distMin)
+				{
+					dist = (-b + root) * aInv;
+					if (dist < ray_distMin)
+						continue;
+				}
+				++hits;
+				if (frame->record[i].type == shape_none || dist < frame->record[i].dist)
+				{
+					frame->record[i].type = shape_sphere;
+					frame->record[i].index = s;
+					frame->record[i].dist = dist;
+				}
+			}
+			stats_out->tests += (ui64)(rect.x1 - rect.x0 + 1);
+			counters_add(counter_testsSphere, rect.x1 - rect.x0 + 1);
+			counters_add(counter_hits, hits);
+		}
+	}
+
+	// intersect: cylinders
+	for (s = 0; s < scene->numCylinders; ++s)
+	{
+		if (!fCullGetBounds(cull, viewport, scene->numSpheres + s, &rect))
+			continue;
+		for (y = rect.y0; y <= rect.y1; ++y)
+		{
+			for (x = rect.x0, i = (ui32)y * (ui32)frame->width + (ui32)x; x <= rect.x1; ++x, ++i)
+			{
+				vec3fInit(ray.direction.v, wave->direction[0][i], wave->direction[1][i], wave->direction[2][i]);
+				if (fRayTestCylinderFinite(&ray, scene, s, &hit) &&
+					(frame->record[i].type == shape_none || hit.dist < frame->record[i].dist))
+					frame->record[i] = hit;
+			}
+			stats_out->tests += (ui64)(rect.x1 - rect.x0 + 1);
+		}
+	}
+	perf_end(perf_intersect);
+	ijk_zone_end();
+	stats_out->msStage[wave_intersect] = ijkTimerLap(wave->timer) * 1000.0;
+
+	// compact: misses resolve now, hits are queued
+	ijk_zone_begin("compact");
+	perf_begin(perf_compact);
+	for (i = 0, wave->shades = 0; i < count; ++i)
+	{
+		if (frame->record[i].type == shape_none)
+			frame->color[i] = scene->color_bg;
+		else
+			wave->shade[wave->shades++] = i;
+	}
+
+	// compact: unlit surfaces resolve now, lit ones emit shadow rays
+	fPointLightGet(scene, 0, &light);
+	for (j = 0, wave->shadows = 0; j < wave->shades; ++j)
+	{
+		sWaveShadow* const shadow = wave->shadow + wave->shadows;
+		i = wave->shade[j];
+		vec3fInit(ray.direction.v, wave->direction[0][i], wave->direction[1][i], wave->direction[2][i]);
+		fRecordGetSurface(frame->record + i, &ray, scene, &point, &normal, &shadow->ramp);
+		if (fShapeCalcLambert(point.v, normal.v, light.v, shadow->ray.direction.v) <= shade_lambertLight)
+		{
+			frame->color[i] = shadow->ramp.color[0];
+			continue;
+		}
+		shadow->ray.origin = point;
+		shadow->pixel = i;
+		++wave->shadows;
+	}
+	perf_end(perf_compact);
+	ijk_zone_end();
+	stats_out->msStage[wave_compact] = ijkTimerLap(wave->timer) * 1000.0;
+
+	// shade
+	ijk_zone_begin("shade");
+	perf_begin(perf_shade);
+	for (j = 0; j < wave->shadows; ++j)
+	{
+		sWaveShadow const* const shadow = wave->shadow + j;
+		frame->color[shadow->pixel] = shadow->ramp.color[!fRayTestAny(&shadow->ray, scene, 1.0f)];
+	}
+	perf_end(perf_shade);
+	ijk_zone_end();
+	stats_out->msStage[wave_shade] = ijkTimerLap(wave->timer) * 1000.0;
+}
+
+// Render frame with kernel specialized for projection and shading model
+//	-> kernels only produce colors, so hit records are cleared to misses: 
+//		reprojection traces the next frame and anti-aliasing finds no edges
+//	-> perspective kernels test the tile lists when culling bins shapes; 
+//		tiles are found along perspective rays, so orthographic ones do not
+//	-> scenes with one shape type use the kernel for that type alone
+ijk_inl void fFrameKernel(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, eKernelProjection const projection, eKernelShading const shading, sFrameStats* const stats_out)
+{
+	eKernelShapes const shapes = !scene->numCylinders ? kernel_spheres : !scene->numSpheres ? kernel_cylinders : kernel_shapesAll;
+	fKernelFrame const kernel = fKernelGet(projection, shapes, shading);
+	bool const binned = projection == kernel_persp && (cull->mode == cull_bins || cull->mode == cull_sortedBins);
+	sKernelFrame const desc = {
+		scene, camera->location, camera->yawCos, camera->yawSin,
+		viewport->viewWidth, viewport->viewHeight, viewport->viewDist,
+		frame->width, frame->height, frame->color,
+		binned ? cull->bin : 0, cull->offset, cull_tileSize, cull->tilesX,
+	};
+	ui16 x, y;
+	ui32 i, count;
+
+	fFrameStatsReset(stats_out, (ui32)frame->width * (ui32)frame->height);
+	if (!kernel || viewport->width != frame->width || viewport->height != frame->height)
+		return;
+	stats_out->rays = stats_out->pixels;
+	stats_out->tests = stats_out->testsAll = (ui64)stats_out->rays * (ui64)cull->shapes;
+	if (binned)
+	{
+		for (y = 0, stats_out->tests = 0; y < frame->height; ++y)
+		{
+			for (x = 0; x < frame->width; ++x)
+			{
+				fCullGetList(cull, x, y, &count);
+				stats_out->tests += count;
+			}
+		}
+	}
+	frame->camera = *camera;
+	kernel(&desc);
+	for (i = 0; i < stats_out->pixels; ++i)
+	{
+		frame->record[i].type = shape_none;
+		frame->record[i].index = 0;
+		frame->record[i].dist = 0.0f;
+	}
+}
+
+// Test if two pixels in frame have the same shape and color
+ijk_inl bool fFramePixelIsSame(sFrame const* const frame, ui32 const i_lh, ui32 const i_rh)
+{
+	return (frame->color[i_lh] == frame->color[i_rh] && fRecordIsSameShape(frame->record + i_lh, frame->record + i_rh));
+}
+
+// Trace pixel for adaptive sampling if not already traced
+ijk_inl ui32 fFrameSampleAdaptive(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, ui16 const x, ui16 const y, sFrameStats* const stats_out)
+{
+	ui32 const i = (ui32)y * (ui32)frame->width + (ui32)x;
+	if (frame->flag[i] < flag_sampled)
+	{
+		sRay ray;
+		sRecord* const hit = frame->record + i;
+		float_t distNext, lambert;
+		ui32 count;
+		sShapeRef const* const shape = fCullGetList(cull, x, y, &count);
+		fRayInitPrimary(&ray, viewport, &frame->camera, x, y);
+		stats_out->tests += fRayTestClosestNext(&ray, scene, shape, count, hit, &distNext);
+		frame->color[i] = fRecordCalcShade(hit, &ray, scene, &lambert);
+		frame->flag[i] = ((distNext > 0.0f && distNext - hit->dist < adaptive_gapNear * hit->dist) ||
+			(hit->type != shape_none && lambert > shade_lambertLight - adaptive_lambertNear && lambert < shade_lambertLight + adaptive_lambertNear))
+			? flag_sampledNear : flag_sampled;
+		++stats_out->rays;
+		stats_out->testsAll += cull->shapes;
+	}
+	return i;
+}
+
+// Render block for adaptive sampling
+//	-> block spans size + 1 pixels per side so neighbors share corners; 
+//		corners are traced and compared: if they all agree on shape and 
+//		color, remaining pixels are filled, otherwise block is split in 
+//		four until blocks are made of corners only; a corner close to a 
+//		change (shape just behind its hit, or shading near threshold) also 
+//		splits, since the change may happen between corners
+//	-> a block any other shape's projected bounds touch also splits, so a 
+//		shape small enough to fit between corners cannot be missed
+//	-> filled pixels copy a corner's record, so their distance is only an 
+//		estimate
+ijk_inl void fFrameTraceBlock(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, ui16 const x0, ui16 const y0, ui16 const size, sFrameStats* const stats_out)
+{
+	if (x0 >= frame->width || y0 >= frame->height)
+		return;
+
+	ui16 const x1 = ijk_minimum(x0 + size, frame->width - 1), y1 = ijk_minimum(y0 + size, frame->height - 1);
+	ui32 const i00 = fFrameSampleAdaptive(frame, viewport, scene, cull, x0, y0, stats_out);
+	ui32 const i10 = fFrameSampleAdaptive(frame, viewport, scene, cull, x1, y0, stats_out);
+	ui32 const i01 = fFrameSampleAdaptive(frame, viewport, scene, cull, x0, y1, stats_out);
+	ui32 const i11 = fFrameSampleAdaptive(frame, viewport, scene, cull, x1, y1, stats_out);
+	ijkConsoleColor const color = frame->color[i00];
+	sRecord const* const hit = frame->record + i00;
+	sRect const block = { (i16)x0, (i16)y0, (i16)x1, (i16)y1 };
+	ui16 x, y, half;
+	ui32 i;
+
+	if (size <= 1)
+		return;
+	if (!fFramePixelIsSame(frame, i00, i10) || !fFramePixelIsSame(frame, i00, i01) || !fFramePixelIsSame(frame, i00, i11) ||
+		frame->flag[i00] == flag_sampledNear || frame->flag[i10] == flag_sampledNear ||
+		frame->flag[i01] == flag_sampledNear || frame->flag[i11] == flag_sampledNear ||
+		fCullIsBlockContested(cull, scene, &block, hit->type, hit->index))
+	{
+		half = size / 2;
+		fFrameTraceBlock(frame, viewport, scene, cull, x0, y0, half, stats_out);
+		fFrameTraceBlock(frame, viewport, scene, cull, x0 + half, y0, half, stats_out);
+		fFrameTraceBlock(frame, viewport, scene, cull, x0, y0 + half, half, stats_out);
+		fFrameTraceBlock(frame, viewport, scene, cull, x0 + half, y0 + half, half, stats_out);
+		return;
+	}
+
+	for (y = y0; y <= y1; ++y)
+	{
+		for (x = x0, i = (ui32)y * (ui32)frame->width + (ui32)x0; x <= x1; ++x, ++i)
+		{
+			if (frame->flag[i] == flag_empty)
+			{
+				frame->color[i] = color;
+				frame->record[i] = *hit;
+				frame->flag[i] = flag_filled;
+			}
+		}
+	}
+}
+
+// Render frame with adaptive (coarse-to-fine) sampling
+//	-> starting blocks are visited in order, whose block size should be a 
+//		power of two
+ijk_inl void fFrameTraceAdaptive(sFrame* const frame, sOrder const* const order, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sFrameStats* const stats_out)
+{
+	ui16 x, y;
+	ui32 i;
+	ui32 const count = (ui32)frame->width * (ui32)frame->height;
+	ui16 const blockSize = order->blockSize;
+	ui32 const blocksX = (frame->width + blockSize - 1) / blockSize, blocks = blocksX * ((frame->height + blockSize - 1) / blockSize);
+
+	fFrameStatsReset(stats_out, count);
+	frame->camera = *camera;
+	for (i = 0; i < count; ++i)
+		frame->flag[i] = flag_empty;
+	for (i = 0; i < blocks; ++i)
+	{
+		x = (ui16)(order->block[i] % blocksX * blockSize);
+		y = (ui16)(order->block[i] / blocksX * blockSize);
+		fFrameTraceBlock(frame, viewport, scene, cull, x, y, blockSize, stats_out);
+	}
+
+	// refine: a filled pixel next to a different pixel is on an edge that 
+	//	cut through its block between corners, so trace it; repeat while 
+	//	tracing keeps finding pixels that differ from their fill
+	bool changed = true;
+	ui32 const width = frame->width;
+	while (changed)
+	{
+		changed = false;
+		for (y = 0, i = 0; y < frame->height; ++y)
+		{
+			for (x = 0; x < frame->width; ++x, ++i)
+			{
+				if (frame->flag[i] != flag_filled)
+					continue;
+				if ((x > 0 && !fFramePixelIsSame(frame, i, i - 1)) ||
+					(x + 1 < frame->width && !fFramePixelIsSame(frame, i, i + 1)) ||
+					(y > 0 && !fFramePixelIsSame(frame, i, i - width)) ||
+					(y + 1 < frame->height && !fFramePixelIsSame(frame, i, i + width)))
+				{
+					ijkConsoleColor const color = frame->color[i];
+					sRecord const hit = frame->record[i];
+					fFrameSampleAdaptive(frame, viewport, scene, cull, x, y, stats_out);
+					if (frame->color[i] != color || !fRecordIsSameShape(&hit, frame->record + i))
+						changed = true;
+				}
+			}
+		}
+	}
+}
+
+// Maximum anti-aliasing samples per side of pixel
+#define aa_samplesMax 4
+
+// Anti-aliasing budget in extra samples per pixel of frame
+#define aa_budget 0.5f
+
+// Anti-alias pixel: sample stratified grid and pick color by coverage
+//	-> the shape covering most samples is the pixel's shape; whatever 
+//		covers most of the rest (background or another shape) is behind it
+//	-> coverage weighs the shape's light samples fully and dark samples 
+//		half: the pixel takes the light entry if mostly covered and lit, 
+//		the dark entry if partly covered, or the color behind it if not
+ijk_inl ijkConsoleColor fFrameSampleAntiAlias(sFrame const* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, ui16 const x, ui16 const y, ui16 const samples, sFrameStats* const stats_out)
+{
+	sRay ray;
+	sRecord hit[aa_samplesMax * aa_samplesMax];
+	ijkConsoleColor color[aa_samplesMax * aa_samplesMax];
+	ui16 const count = samples * samples;
+	float_t const step = 1.0f / (float_t)samples;
+	ui16 sx, sy, i, j, n, n_shape = 0, n_behind = 0, i_shape = count, i_behind = count;
+	sColor ramp;
+	ui32 count_shape;
+	sShapeRef const* const shape = fCullGetList(cull, x, y, &count_shape);
+
+	// stratified: one sample at the center of each cell of a grid in pixel
+	for (sy = 0, i = 0; sy < samples; ++sy)
+	{
+		for (sx = 0; sx < samples; ++sx, ++i)
+		{
+			fRayInitPrimaryOffset(&ray, viewport, &frame->camera, x, y,
+				((float_t)sx + 0.5f) * step - 0.5f, ((float_t)sy + 0.5f) * step - 0.5f);
+			stats_out->tests += fRayCalcColor(&ray, scene, shape, count_shape, color + i, hit + i);
+		}
+	}
+	stats_out->samples += count;
+	stats_out->testsAll += (ui64)count * (ui64)cull->shapes;
+
+	// majority shape
+	for (i = 0; i < count; ++i)
+	{
+		if (hit[i].type == shape_none)
+			continue;
+		for (j = 0, n = 0; j < count; ++j)
+			n += fRecordIsSameShape(hit + i, hit + j);
+		if (n > n_shape)
+		{
+			n_shape = n;
+			i_shape = i;
+		}
+	}
+	if (i_shape == count || !fRecordGetColor(hit + i_shape, scene, &ramp))
+		return scene->color_bg;
+
+	// majority color of the rest
+	for (i = 0; i < count; ++i)
+	{
+		if (fRecordIsSameShape(hit + i_shape, hit + i))
+			continue;
+		for (j = 0, n = 0; j < count; ++j)
+			n += (color[i] == color[j]);
+		if (n > n_behind)
+		{
+			n_behind = n;
+			i_behind = i;
+		}
+	}
+
+	// coverage weighted by shading
+	for (i = 0, n = 0; i < count; ++i)
+		if (fRecordIsSameShape(hit + i_shape, hit + i))
+			n += (color[i] == ramp.color[1]) ? 2 : 1;
+	if (n * 4 >= count * 3 * 2 || i_behind == count)
+		return ramp.color[n * 4 >= count * 3 * 2];
+	if (n * 4 >= count * 2)
+		return ramp.color[0];
+	return color[i_behind];
+}
+
+// Anti-alias frame along shape edges
+//	-> a pixel is on an edge if any neighbor's primary hit is on a different 
+//		shape; edge pixels get samplesMax x samplesMax samples, reduced 
+//		so that extra samples stay within a budget for the whole frame
+ijk_inl void fFrameAntiAlias(sFrame* const frame, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, ui16 samplesMax, sFrameStats* const stats_out)
+{
+	ui16 x, y;
+	ui32 i, edges = 0;
+	ui32 const width = frame->width;
+	ui32 const budget = (ui32)(aa_budget * (float_t)frame->width * (float_t)frame->height);
+
+	if (samplesMax > aa_samplesMax)
+		samplesMax = aa_samplesMax;
+
+	// mark edges
+	for (y = 0, i = 0; y < frame->height; ++y)
+	{
+		for (x = 0; x < frame->width; ++x, ++i)
+		{
+			sRecord const* const hit = frame->record + i;
+			bool const edge = (x > 0 && !fRecordIsSameShape(hit, hit - 1)) ||
+				(x + 1 < frame->width && !fRecordIsSameShape(hit, hit + 1)) ||
+				(y > 0 && !fRecordIsSameShape(hit, hit - width)) ||
+				(y + 1 < frame->height && !fRecordIsSameShape(hit, hit + width));
+			frame->flag[i] = edge ? flag_edge : flag_empty;
+			edges += edge;
+		}
+	}
+
+	// fit samples to budget; past that, edges keep their single sample
+	while (samplesMax > 2 && edges * samplesMax * samplesMax > budget)
+		--samplesMax;
+	for (y = 0, i = 0; y < frame->height; ++y)
+	{
+		for (x = 0; x < frame->width; ++x, ++i)
+		{
+			if (frame->flag[i] != flag_edge || stats_out->samples + samplesMax * samplesMax > budget)
+				continue;
+			frame->color[i] = fFrameSampleAntiAlias(frame, viewport, scene, cull, x, y, samplesMax, stats_out);
+			++stats_out->edges;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+// Primary visibility engines
+typedef enum eEngine_t
+{
+	engine_trace,				// Trace every pixel
+	engine_reproject,			// Reproject previous frame, trace the rest
+	engine_adaptive,			// Trace block corners, subdivide where they differ
+	engine_raster,				// Rasterize spheres, trace cylinders
+	engine_scanline,			// Step sphere tests along rows, trace cylinders
+	engine_wavefront,			// Generate, intersect and shade in staged queues
+	engine_kernel,				// Specialized C++ kernel, bins if perspective
+	engine_count
+} eEngine;
+
+// Engine, culling and order names, as shown in status and given on command line
+static kstr const engineName[engine_count] = { "trace", "reproject", "adaptive", "raster", "scanline", "wavefront", "kernel" };
+static kstr const cullName[cull_count] = { "none", "bins", "sorted", "sorted+bins" };
+static kstr const orderName[order_count] = { "row", "morton", "hilbert" };
+
+// Draw settings, toggled at run time
+typedef struct sDrawSettings_t
+{
+	eEngine engine;				// Engine used to render frame
+	ui16 blockSize;				// Starting block size for adaptive sampling
+	ui16 samplesAA;				// Anti-aliasing samples per side of edge pixels (0 is off)
+	eCull cull;					// Culling of shapes tested by primary rays
+	eOrder order;				// Order pixels and blocks are traced in
+	eKernelProjection projection;	// Projection of kernel engine
+	eKernelShading shading;		// Shading model of kernel engine
+	bool hud;					// Show performance row over frame (counts while shown)
+	bool trace;					// Record profiler zones (trace written when turned off)
+	bool latency;				// Show input-to-present latency in status
+} sDrawSettings;
+
+// Render frame with engine and anti-aliasing from settings
+//	-> reprojection traces if there is no previous frame
+//	-> order lists should be updated to settings beforehand
+ijk_inl void fFrameRender(sFrame* const frame, sFrame const* const frame_prev, sWavefront* const wave, sOrder const* const order, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sDrawSettings const* const settings, sFrameStats* const stats_out)
+{
+	ijk_zone_begin("render");
+	perf_begin(perf_render);
+	ijk_zone_begin(engineName[settings->engine]);
+	switch (settings->engine)
+	{
+	case engine_reproject:
+		if (frame_prev)
+		{
+			fFrameReproject(frame, frame_prev, viewport, scene, cull, camera, stats_out);
+			break;
+		}
+		// no previous frame: trace
+	case engine_trace:
+		fFrameTrace(frame, order, viewport, scene, cull, camera, stats_out);
+		break;
+	case engine_adaptive:
+		fFrameTraceAdaptive(frame, order, viewport, scene, cull, camera, stats_out);
+		break;
+	case engine_raster:
+		fFrameRaster(frame, viewport, scene, cull, camera, stats_out);
+		break;
+	case engine_scanline:
+		fFrameScanline(frame, viewport, scene, cull, camera, stats_out);
+		break;
+	case engine_wavefront:
+		fFrameWavefront(frame, wave, viewport, scene, cull, camera, stats_out);
+		break;
+	case engine_kernel:
+		fFrameKernel(frame, viewport, scene, cull, camera, settings->projection, settings->shading, stats_out);
+		break;
+	}
+	ijk_zone_end();
+	if (settings->samplesAA)
+	{
+		ijk_zone_begin("antialias");
+		fFrameAntiAlias(frame, viewport, scene, cull, settings->samplesAA, stats_out);
+		ijk_zone_end();
+	}
+	perf_end(perf_render);
+	ijk_zone_end();
+}
+
+// Benchmark results per engine
+//	-> engines are compared to tracing every pixel: pixels whose color 
+//		differs, and the largest relative error in depth where both hit 
+//		the same shape
+//	-> tracing is also timed in each traversal order; tile changes stand 
+//		in for cache misses, since each one moves rays onto another list
+typedef struct sBenchmark_t
+{
+	ui32 frames;				// Frames rendered per engine
+	f64 ms[engine_count];		// Mean time per frame in milliseconds
+	ui32 differ[engine_count];	// Pixels whose color differs from tracing
+	f32 error[engine_count];	// Largest relative depth error against tracing
+	f64 msOrder[order_count];	// Mean time per traced frame per order
+	f64 raysOrder[order_count];	// Primary rays per second per order
+	ui32 switchesOrder[order_count];	// Culling tile changes per order
+	ui32 ulpRecip, ulpSqrt, ulpSqrtInv;	// Largest fast math errors in ULP
+} sBenchmark;
+
+// Frames rendered per engine when benchmarking
+#define benchmark_frames 64
+
+// Step between float bit patterns sampled when measuring fast math error
+#define benchmark_ulpStep 257
+
+// Benchmark engines against tracing every pixel from camera
+//	-> renders the same view repeatedly with each engine (reprojection is 
+//		skipped since a still view is only a copy); 'frame_ref' is left with 
+//		the traced result and 'frame' with the last engine's
+//	-> order lists are rebuilt per traversal order, then restored
+ijk_inl bool fFrameBenchmark(sFrame* const frame, sFrame* const frame_ref, sWavefront* const wave, sOrder* const order, sViewport const* const viewport, sScene const* const scene, sCull const* const cull, sCamera const* const camera, sDrawSettings const* const settings, sBenchmark* const benchmark_out)
+{
+	ijkTimer timer[1];
+	sFrameStats stats;
+	sDrawSettings run;
+	ui32 i, n;
+	f32 error;
+
+	if (!frame || !frame_ref || frame->width != frame_ref->width || frame->height != frame_ref->height ||
+		!settings || !benchmark_out || !ijk_issuccess(ijkTimerInit(timer)))
+		return false;
+
+	ui32 const count = (ui32)frame->width * (ui32)frame->height;
+	sBenchmark const reset = { benchmark_frames };
+	*benchmark_out = reset;
+	for (run = *settings, run.order = order_row; run.order < order_count; ++run.order)
+	{
+		fOrderUpdate(order, run.order, run.blockSize);
+		run.engine = engine_trace;
+		ijkTimerStart(timer);
+		for (n = 0; n < benchmark_frames; ++n)
+			fFrameRender(frame, 0, wave, order, viewport, scene, cull, camera, &run, &stats);
+		benchmark_out->msOrder[run.order] = ijkTimerElapsed(timer) * 1000.0 / (f64)benchmark_frames;
+		benchmark_out->raysOrder[run.order] = (f64)stats.rays * 1000.0 / benchmark_out->msOrder[run.order];
+		benchmark_out->switchesOrder[run.order] = stats.switches;
+	}
+	fOrderUpdate(order, settings->order, settings->blockSize);
+	benchmark_out->ulpRecip = fRecipFastErrorULP(benchmark_ulpStep);
+	benchmark_out->ulpSqrt = fSqrtFastErrorULP(benchmark_ulpStep);
+	benchmark_out->ulpSqrtInv = fSqrtInvFastErrorULP(benchmark_ulpStep);
+	for (run = *settings, run.engine = engine_trace; run.engine < engine_count; ++run.engine)
+	{
+		sFrame* const target = run.engine == engine_trace ? frame_ref : frame;
+		if (run.engine == engine_reproject)
+			continue;
+
+		ijkTimerStart(timer);
+		for (n = 0; n < benchmark_frames; ++n)
+			fFrameRender(target, 0, wave, order, viewport, scene, cull, camera, &run, &stats);
+		benchmark_out->ms[run.engine] = ijkTimerElapsed(timer) * 1000.0 / (f64)benchmark_frames;
+		for (i = 0; i < count; ++i)
+		{
+			sRecord const* const hit = target->record + i, * const hit_ref = frame_ref->record + i;
+			benchmark_out->differ[run.engine] += (target->color[i] != frame_ref->color[i]);
+			if (hit->type == shape_none || !fRecordIsSameShape(hit, hit_ref))
+				continue;
+			error = (hit->dist - hit_ref->dist) / hit_ref->dist;
+			error = error < 0.0f ? -error : error;
+			if (error > benchmark_out->error[run.engine])
+				benchmark_out->error[run.engine] = error;
+		}
+	}
+	return true;
+}
+
+ijk_inl void ijkConsoleDrawPixel(ijkConsole const* const console, ijkConsoleColor const color, i16 const x_viewport, i16 const y_viewport)
+{
+	ijkConsoleSetCursorColor(x_viewport * 2, y_viewport * 1, color, color);
+	printf("  ");
+	counters_add(counter_consoleCalls, 1);
+	counters_add(counter_syscalls, 1);
+	counters_add(counter_bytes, 2);
+}
+
+// Count cells whose color changed since previous frame (all if none)
+ijk_inl void fFrameCountChanged(sFrame const* const frame, sFrame const* const frame_prev)
+{
+#ifdef IJK_PLAYER_COUNTERS
+	ui32 i, changed;
+	ui32 const count = (ui32)frame->width * (ui32)frame->height;
+	if (!countersLocal)
+		return;
+	for (i = 0, changed = 0; i < count; ++i)
+		changed += !frame_prev || frame->color[i] != frame_prev->color[i];
+	counters_add(counter_cellsChanged, changed);
+#endif	// IJK_PLAYER_COUNTERS
+}
+
+ijk_inl void ijkConsoleDrawFrame(ijkConsole const* const console, sFrame const* const frame)
+{
+	ui16 x, y;
+	ui32 i;
+
+	ijk_zone_begin("clear");
+	ijkConsoleClear();
+	counters_add(counter_consoleCalls, 1);
+	ijk_zone_end();
+	ijk_zone_begin("present");
+	for (y = 0, i = 0; y < frame->height; ++y)
+		for (x = 0; x < frame->width; ++x, ++i)
+			ijkConsoleDrawPixel(console, frame->color[i], x, y);
+	ijk_zone_end();
+}
+
+// Format input-to-present latency summary: count and percentiles in ms
+ijk_inl i32 fLatencyFormat(char* const text, ijkHistogram const* const latency)
+{
+	f64 const msPerValue = 0.001;
+	return sprintf(text, "latency: %llu inputs, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms",
+		(unsigned long long)latency->count,
+		(f64)ijkHistogramPercentile(latency, 50.0) * msPerValue, (f64)ijkHistogramPercentile(latency, 95.0) * msPerValue,
+		(f64)ijkHistogramPercentile(latency, 99.0) * msPerValue, (f64)latency->max * msPerValue);
+}
+
+ijk_inl void ijkConsoleDrawStatus(ijkConsole const* const console, sDrawSettings const* const settings, sCull const* const cull, sFrameStats const* const stats, sBenchmark const* const benchmark, ijkHistogram const* const latency, i16 const y_viewport)
+{
+	char text[128];
+	kstr const projectionName[kernel_projectionCount] = { "persp", "ortho" };
+	kstr const shadingName[kernel_shadingCount] = { "flat", "lambert", "shadowed" };
+	f64 const pixelsInv = 100.0 / (f64)(stats->pixels ? stats->pixels : 1);
+	eEngine engine;
+	eOrder order;
+
+	ijkConsoleSetCursorColor(0, y_viewport, ijkConsoleColor_white, ijkConsoleColor_black);
+	printf("[t] engine: %-9s [b] block: %u | rays %u/%u (%.1f%%) \n",
+		engineName[settings->engine], (ui32)settings->blockSize,
+		stats->rays, stats->pixels, (f64)stats->rays * pixelsInv);
+	if (settings->engine == engine_reproject)
+		printf("reused %u (%.1f%%), rejected %u, disoccluded %u \n",
+			stats->reused, (f64)stats->reused * pixelsInv, stats->rejected, stats->disoccluded);
+	else if (settings->engine == engine_raster)
+		printf("rasterized %u (%.1f%%) \n",
+			stats->rasterized, (f64)stats->rasterized * pixelsInv);
+	else if (settings->engine == engine_scanline)
+		printf("full solves near silhouettes %u (%.1f%%) \n",
+			stats->fallback, (f64)stats->fallback * pixelsInv);
+	else if (settings->engine == engine_wavefront)
+		printf("generate %.3f ms, intersect %.3f ms, compact %.3f ms, shade %.3f ms \n",
+			stats->msStage[wave_generate], stats->msStage[wave_intersect],
+			stats->msStage[wave_compact], stats->msStage[wave_shade]);
+	else if (settings->engine == engine_kernel)
+		printf("[p] projection: %s, [h] shading: %s \n",
+			projectionName[settings->projection], shadingName[settings->shading]);
+	printf("[g] anti-alias: %ux%u | edges %u, samples %u (+%.1f%%) \n",
+		(ui32)settings->samplesAA, (ui32)settings->samplesAA,
+		stats->edges, stats->samples, (f64)stats->samples * pixelsInv);
+	printf("[c] cull: %-11s | visible %u/%u, tests %llu/%llu (%.1f%% skipped) \n",
+		cullName[cull->mode], cull->visible, cull->shapes,
+		(unsigned long long)stats->tests, (unsigned long long)stats->testsAll,
+		stats->testsAll ? 100.0 - (f64)stats->tests * 100.0 / (f64)stats->testsAll : 0.0);
+	printf("[o] order: %-7s | tile changes %u (%.1f%% of rays) \n",
+		orderName[settings->order], stats->switches, (f64)stats->switches * 100.0 / (f64)(stats->rays ? stats->rays : 1));
+	printf("[k] benchmark %u frames per engine \n", benchmark->frames);
+	for (order = order_row; order < order_count && benchmark->frames; ++order)
+		printf("    trace %-7s %8.3f ms, %7.3f Mrays/s | tile changes %u \n",
+			orderName[order], benchmark->msOrder[order], benchmark->raysOrder[order] * 1.0e-6, benchmark->switchesOrder[order]);
+	if (benchmark->frames)
+		printf("    fast math error: recip %u ulp, sqrt %u ulp, sqrt inverse %u ulp \n",
+			benchmark->ulpRecip, benchmark->ulpSqrt, benchmark->ulpSqrtInv);
+	for (engine = engine_trace; engine < engine_count && benchmark->frames; ++engine)
+		if (benchmark->ms[engine] > 0.0)
+			printf("    %-9s %8.3f ms (%5.2fx) | differ %u, depth error %.1e \n",
+				engineName[engine], benchmark->ms[engine], benchmark->ms[engine_trace] / benchmark->ms[engine],
+				benchmark->differ[engine], (f64)benchmark->error[engine]);
+	if (settings->latency)
+	{
+		fLatencyFormat(text, latency);
+		printf("%s \n", text);
+	}
+	printf("[wasd/rf] move, [qe] turn, [u] hud, [l] latency, [z] trace: %-3s [x] exit \n", settings->trace ? "on" : "off");
+}
+
+// Draw performance row over top row of frame: time and rate of last frame 
+//	(render and present, not waiting for input), then its counters: rays, 
+//	sphere and cylinder tests, hits, shadow rays | cells changed, bytes, 
+//	writes and console calls
+ijk_inl void ijkConsoleDrawHud(ijkConsole const* const console, sCounters const* const counters, f64 const ms, ui16 const width)
+{
+	char text[256];
+	i32 length = sprintf(text, " %.2f ms %.0f fps", ms, ms > 0.0 ? 1000.0 / ms : 0.0);
+#ifdef IJK_PLAYER_COUNTERS
+	ui64 const* const count = counters->count;
+	length += sprintf(text + length, " | ray %llu sph %llu cyl %llu hit %llu shd %llu | chg %llu %lluB %lluw %lluc",
+		(unsigned long long)count[counter_rays], (unsigned long long)count[counter_testsSphere], (unsigned long long)count[counter_testsCylinder],
+		(unsigned long long)count[counter_hits], (unsigned long long)count[counter_shadowRays], (unsigned long long)count[counter_cellsChanged],
+		(unsigned long long)count[counter_bytes], (unsigned long long)count[counter_syscalls], (unsigned long long)count[counter_consoleCalls]);
+#endif	// IJK_PLAYER_COUNTERS
+	ijkConsoleSetCursorColor(0, 0, ijkConsoleColor_white, ijkConsoleColor_blue_d);
+	printf("%-*.*s", (i32)width * 2, ijk_minimum(length, (i32)width * 2), text);
+	ijkConsoleResetColor();
+}
+
+// Apply key to camera and settings; returns false when done
+ijk_inl bool ijkConsoleDrawInput(sCamera* const camera, sDrawSettings* const settings, bool* const benchmark_out, i32 const key)
+{
+	f32 const moveStep = 0.25f, turnStep = 0.0625f;
+
+	switch (key)
+	{
+	case 'w': fCameraMove(camera, 0.0f, 0.0f, +moveStep);	break;
+	case 's': fCameraMove(camera, 0.0f, 0.0f, -moveStep);	break;
+	case 'a': fCameraMove(camera, -moveStep, 0.0f, 0.0f);	break;
+	case 'd': fCameraMove(camera, +moveStep, 0.0f, 0.0f);	break;
+	case 'r': fCameraMove(camera, 0.0f, +moveStep, 0.0f);	break;
+	case 'f': fCameraMove(camera, 0.0f, -moveStep, 0.0f);	break;
+	case 'q': fCameraTurn(camera, +turnStep);				break;
+	case 'e': fCameraTurn(camera, -turnStep);				break;
+	case 't': settings->engine = (settings->engine + 1) % engine_count;	break;
+	case 'b': settings->blockSize = settings->blockSize == 4 ? 8 : 4;	break;
+	case 'g': settings->samplesAA = settings->samplesAA < aa_samplesMax ? ijk_maximum(settings->samplesAA + 1, 2) : 0;	break;
+	case 'c': settings->cull = (settings->cull + 1) % cull_count;	break;
+	case 'o': settings->order = (settings->order + 1) % order_count;	break;
+	case 'p': settings->projection = (settings->projection + 1) % kernel_projectionCount;	break;
+	case 'h': settings->shading = (settings->shading + 1) % kernel_shadingCount;	break;
+	case 'k': *benchmark_out = true;	break;
+	case 'u': settings->hud = !settings->hud;	break;
+	case 'z': settings->trace = !settings->trace;	break;
+	case 'l': settings->latency = !settings->latency;	break;
+	case 'x':
+	case EOF:
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// ENCODING
+
+// Frames bound for a headless sink (file, pipe or terminal) are encoded as 
+//	the byte stream a terminal would receive: cursor home, then each row of 
+//	two-space cells, with an ANSI background color sequence only where the 
+//	color changes along the row
+
+// Largest encoded size of frame in bytes, full or delta
+ijk_inl size_t fFrameEncodeCapacity(ui16 const width, ui16 const height)
+{
+	// full: home (3); per cell, color (6) and cell (2); per row, reset and 
+	//	break (5); delta: per cell, move (14), color and cell; reset and move 
+	//	below (18); delta is always larger
+	return (18 + (size_t)height * (size_t)width * 22);
+}
+
+// Open sink for frames by path, "-" being standard output; encoded frames 
+//	are binary, so standard output leaves text mode to pass them unchanged
+ijk_inl FILE* fFrameOpenSink(kstr const path, bool const encoded)
+{
+	if (strcmp(path, "-"))
+		return fopen(path, encoded ? "wb" : "w");
+#if ijk_platform_is(WINDOWS)
+	if (encoded)
+	{
+		fflush(stdout);
+		if (_setmode(_fileno(stdout), _O_BINARY) == -1)
+			return 0;
+	}
+#endif	// WINDOWS
+	return stdout;
+}
+
+// Encode background color sequence; returns end of sequence
+ijk_inl byte* fFrameEncodeColor(byte* out, ui32 const c)
+{
+	// ANSI background per color: channel order is reversed (blue is the low 
+	//	bit here, red is in ANSI) and intensity selects the bright range
+	static ui8 const code[16] = { 40, 44, 42, 46, 41, 45, 43, 47, 100, 104, 102, 106, 101, 105, 103, 107 };
+	*out++ = '\x1b';
+	*out++ = '[';
+	if (code[c] >= 100)
+		*out++ = '1';
+	*out++ = (byte)('0' + code[c] / 10 % 10);
+	*out++ = (byte)('0' + code[c] % 10);
+	*out++ = 'm';
+	return out;
+}
+
+// Encode cursor move to one-based row and column; returns end of sequence
+ijk_inl byte* fFrameEncodeMove(byte* out, ui32 const row, ui32 const column)
+{
+	byte digit[10];
+	ui32 n, value;
+	*out++ = '\x1b';
+	*out++ = '[';
+	for (n = 0, value = row; n == 0 || value; value /= 10)
+		digit[n++] = (byte)('0' + value % 10);
+	while (n)
+		*out++ = digit[--n];
+	*out++ = ';';
+	for (n = 0, value = column; n == 0 || value; value /= 10)
+		digit[n++] = (byte)('0' + value % 10);
+	while (n)
+		*out++ = digit[--n];
+	*out++ = 'H';
+	return out;
+}
+
+// Encode frame colors to buffer of at least encode capacity; returns size
+ijk_inl size_t fFrameEncode(byte* const buffer, ijkConsoleColor const* const color, ui16 const width, ui16 const height)
+{
+	byte* out = buffer;
+	ui16 x, y;
+	ui32 i, c, last;
+
+	memcpy(out, "\x1b[H", 3);
+	out += 3;
+	for (y = 0, i = 0; y < height; ++y)
+	{
+		for (x = 0, last = 16; x < width; ++x, ++i)
+		{
+			c = color[i] & 0xf;
+			if (c != last)
+			{
+				out = fFrameEncodeColor(out, c);
+				last = c;
+			}
+			*out++ = ' ';
+			*out++ = ' ';
+		}
+		memcpy(out, "\x1b[0m\n", 5);
+		out += 5;
+	}
+	return (size_t)(out - buffer);
+}
+
+// Encode only cells whose color changed since previous frame; returns size, 
+//	zero if nothing changed
+//	-> each run of changed cells along a row starts with a cursor move; the 
+//		color carries over between runs, and the cursor is left below the 
+//		frame as the full encoding leaves it
+ijk_inl size_t fFrameEncodeDelta(byte* const buffer, ijkConsoleColor const* const color, ijkConsoleColor const* const color_prev, ui16 const width, ui16 const height)
+{
+	byte* out = buffer;
+	ui16 x, y;
+	ui32 i, c, last = 16;
+	bool run;
+
+	for (y = 0, i = 0; y < height; ++y)
+	{
+		for (x = 0, run = false; x < width; ++x, ++i)
+		{
+			c = color[i] & 0xf;
+			if (c == (ui32)(color_prev[i] & 0xf))
+			{
+				run = false;
+				continue;
+			}
+			if (!run)
+				out = fFrameEncodeMove(out, (ui32)y + 1, (ui32)x * 2 + 1);
+			if (c != last)
+				out = fFrameEncodeColor(out, c);
+			*out++ = ' ';
+			*out++ = ' ';
+			run = true;
+			last = c;
+		}
+	}
+	if (out != buffer)
+	{
+		memcpy(out, "\x1b[0m", 4);
+		out = fFrameEncodeMove(out + 4, (ui32)height + 1, 1);
+	}
+	return (size_t)(out - buffer);
+}
+
+
+//-----------------------------------------------------------------------------
+// OPTIONS
+
+// Generated scene layout names, as given on command line
+static kstr const sceneLayoutName[scene_layoutCount] = { "uniform", "clustered", "blob" };
+
+// Benchmark run by benchmark entry point
+typedef enum eBench_t
+{
+	bench_render,				// Render frames end to end
+	bench_micro,				// Time vector operations and ray tests in isolation
+	bench_output,				// Present synthetic frames through each output path
+	bench_ulp,					// Measure fast math error over every float
+} eBench;
+
+// Player options from command line
+typedef struct sOptions_t
+{
+	bool batch;					// Render frame range offline instead of interactively
+	ui32 frameFirst, frameLast;	// Range of frames rendered in batch (inclusive)
+	ui32 frames;				// Frames measured after warm-up (sets range from zero)
+	ui32 threads;				// Worker threads in batch (0 is one per core)
+	ui32 warmup;				// Leading frames of batch left out of measurements
+	ui16 width, height;			// Viewport of batch in pixels
+	eEngine engine;				// Engine used in batch
+	eCull cull;					// Culling used in batch
+	char path[256];				// Batch output file ("-" is standard output, empty discards)
+	char trace[256];			// Profiler trace file (empty: batch records none, interactive uses default)
+	char metrics[256];			// Metrics directory ("-" is shared directory, empty publishes none)
+	char ring[256];				// Frame ring directory ("-" is shared directory, empty publishes none)
+	char record[256];			// Recording file (empty records none)
+	char replay[256];			// Recording replayed instead of rendering (empty renders)
+	char load[256];				// Binary scene file used instead of default or generated (empty loads none)
+	bool generate;				// Generate scene instead of using default
+	sSceneDesc scene;			// Description of generated scene (view is filled in later)
+	eBench bench;				// Benchmark to run (benchmark only)
+	bool perf;					// Measure stages with hardware counters (benchmark only)
+} sOptions;
+
+// Read path from command line into option of 256 characters, quoted if 
+//	it holds spaces; path is left as is if missing or too long
+ijk_inl bool fOptionsReadPath(kstr const args, char path_out[256], i32* const read_out)
+{
+	char path[256];
+	kstr c = args + strspn(args, " \t\r\n");
+	ui32 length = 0;
+	bool const quoted = *c == '"';
+	for (c += quoted; *c && (quoted ? *c != '"' : !strchr(" \t\r\n", *c)); ++c)
+	{
+		if (length >= sizeof(path) - 1)
+			return false;
+		path[length++] = *c;
+	}
+	if (!length || (quoted && *c++ != '"'))
+		return false;
+	path[length] = 0;
+	memcpy(path_out, path, (size_t)length + 1);
+	*read_out = (i32)(c - args);
+	return true;
+}
+
+// Parse options from command line
+//	-> recognized: "--batch first:last", "--frames n", "--warmup n", 
+//		"--threads n", "--size widthxheight", "--engine name", "--cull name", 
+//		"--out path", "--trace path", "--metrics dir", "--ring dir", 
+//		"--record path", "--replay path", "--micro", "--output", "--ulp", 
+//		"--perf"; 
+//		unknown words are skipped
+//	-> scene: "--scene layout", "--spheres n", "--cylinders n", "--seed n", 
+//		"--coverage f", "--overlap f"; any of the first three generates it; 
+//		"--load path" maps a binary scene file instead
+//	-> paths may be quoted to hold spaces
+ijk_inl bool fOptionsParse(sOptions* const options, kstr args)
+{
+	char word[32], name[32];
+	bool parsed;
+	i32 read;
+
+	if (!options)
+		return false;
+
+	sOptions const reset = { false, 0, 0, 0, 0, 0, 48, 27, engine_trace, cull_none, "", "", "", "", "", "", "", false, { 1, 0, 0, scene_uniform, 0.8f, 0.5f }, bench_render, false };
+	ui32 width, height;
+	*options = reset;
+	while (args && sscanf(args, "%31s%n", word, &read) == 1)
+	{
+		args += read;
+		if (!strcmp(word, "--batch"))
+			parsed = sscanf(args, " %u:%u%n", &options->frameFirst, &options->frameLast, &read) == 2;
+		else if (!strcmp(word, "--frames"))
+			parsed = sscanf(args, " %u%n", &options->frames, &read) == 1 && options->frames;
+		else if (!strcmp(word, "--warmup"))
+			parsed = sscanf(args, " %u%n", &options->warmup, &read) == 1;
+		else if (!strcmp(word, "--threads"))
+			parsed = sscanf(args, " %u%n", &options->threads, &read) == 1;
+		else if (!strcmp(word, "--size"))
+			parsed = sscanf(args, " %ux%u%n", &width, &height, &read) == 2 && width && height && width <= 0x7fff && height <= 0x7fff;
+		else if (!strcmp(word, "--engine") || !strcmp(word, "--cull") || !strcmp(word, "--scene"))
+			parsed = sscanf(args, " %31s%n", name, &read) == 1;
+		else if (!strcmp(word, "--out"))
+			parsed = fOptionsReadPath(args, options->path, &read);
+		else if (!strcmp(word, "--trace"))
+			parsed = fOptionsReadPath(args, options->trace, &read);
+		else if (!strcmp(word, "--metrics"))
+			parsed = fOptionsReadPath(args, options->metrics, &read);
+		else if (!strcmp(word, "--ring"))
+			parsed = fOptionsReadPath(args, options->ring, &read);
+		else if (!strcmp(word, "--record"))
+			parsed = fOptionsReadPath(args, options->record, &read);
+		else if (!strcmp(word, "--replay"))
+			parsed = fOptionsReadPath(args, options->replay, &read);
+		else if (!strcmp(word, "--load"))
+			parsed = fOptionsReadPath(args, options->load, &read);
+		else if (!strcmp(word, "--spheres"))
+			parsed = options->generate = sscanf(args, " %u%n", &options->scene.numSpheres, &read) == 1;
+		else if (!strcmp(word, "--cylinders"))
+			parsed = options->generate = sscanf(args, " %u%n", &options->scene.numCylinders, &read) == 1;
+		else if (!strcmp(word, "--seed"))
+			parsed = sscanf(args, " %u%n", &options->scene.seed, &read) == 1;
+		else if (!strcmp(word, "--coverage"))
+			parsed = sscanf(args, " %f%n", &options->scene.coverage, &read) == 1;
+		else if (!strcmp(word, "--overlap"))
+			parsed = sscanf(args, " %f%n", &options->scene.overlap, &read) == 1;
+		else if (!strcmp(word, "--micro") || !strcmp(word, "--output") || !strcmp(word, "--ulp"))
+		{
+			options->bench = !strcmp(word, "--micro") ? bench_micro : !strcmp(word, "--output") ? bench_output : bench_ulp;
+			continue;
+		}
+		else if (!strcmp(word, "--perf"))
+		{
+			options->perf = true;
+			continue;
+		}
+		else
+			continue;
+		if (!parsed)
+			continue;
+		args += read;
+		if (!strcmp(word, "--batch"))
+			options->batch = options->frameLast >= options->frameFirst;
+		else if (!strcmp(word, "--size"))
+		{
+			options->width = (ui16)width;
+			options->height = (ui16)height;
+		}
+		else if (!strcmp(word, "--cull"))
+		{
+			for (options->cull = cull_none; options->cull < cull_count; ++options->cull)
+				if (!strcmp(name, cullName[options->cull]))
+					break;
+		}
+		else if (!strcmp(word, "--engine"))
+		{
+			for (options->engine = engine_trace; options->engine < engine_count; ++options->engine)
+				if (!strcmp(name, engineName[options->engine]))
+					break;
+		}
+		else if (!strcmp(word, "--scene"))
+		{
+			options->generate = true;
+			for (options->scene.layout = scene_uniform; options->scene.layout < scene_layoutCount; ++options->scene.layout)
+				if (!strcmp(name, sceneLayoutName[options->scene.layout]))
+					break;
+		}
+	}
+	if (options->frames)
+	{
+		options->batch = true;
+		options->frameFirst = 0;
+		options->frameLast = options->warmup + options->frames - 1;
+	}
+	if (options->engine >= engine_count)
+		options->engine = engine_trace;
+	if (options->cull >= cull_count)
+		options->cull = cull_none;
+	if (options->scene.layout >= scene_layoutCount)
+		options->scene.layout = scene_uniform;
+	return true;
+}
+
+// Create scene from options: loaded from binary scene file if given, 
+//	generated to fill the view if requested, default otherwise
+ijk_inl bool fOptionsCreateScene(sOptions const* const options, sViewport const* const viewport, sScene* const scene)
+{
+	sSceneDesc desc;
+	if (options && options->load[0])
+	{
+		if (fSceneLoad(scene, options->load))
+			return true;
+		dprintf("scene: could not load '%s'\n", options->load);
+		return false;
+	}
+	if (!options || !viewport || !options->generate)
+		return fSceneInit(scene);
+
+	desc = options->scene;
+	desc.viewSlopeX = viewport->viewWidth * 0.5f / viewport->viewDist;
+	desc.viewSlopeY = viewport->viewHeight * 0.5f / viewport->viewDist;
+	return fSceneGenerate(scene, &desc);
+}
+
+
+// Start profiler trace on calling thread, or stop it and write it to path; 
+//	returns whether tracing
+ijk_inl bool fTraceToggle(bool const tracing, kstr const path)
+{
+	if (!tracing)
+	{
+		if (ijk_issuccess(ijkProfilerStart()) && ijk_issuccess(ijkProfilerThreadBegin("main")))
+			return true;
+		ijkProfilerStop();
+		return false;
+	}
+	ijkProfilerThreadEnd();
+	ijkProfilerWrite(path);
+	ijkProfilerStop();
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkConsoleDraw(ijkConsole const* const console, sOptions const* const options)
+{
+	ui16 const width = 48, height = 27;
+	f32 const viewHeight = 2.0f, viewDist = 3.0f;
+
+	i32 key = 0;
+	ui16 frameIndex = 0;
+	bool framePrev = false;
+
+	sViewport viewport;
+	fViewportInit(&viewport, width, height, viewHeight, viewDist);
+
+	sScene scene = { 0 };
+	if (!fOptionsCreateScene(options, &viewport, &scene))
+		return ijk_failcode(ijk_fail_allocation);
+
+	sCamera camera;
+	fCameraInit(&camera, vec3f0.v, 0.0f);
+
+	sDrawSettings settings = { engine_trace, 4, 0, cull_none, order_row, kernel_persp, kernel_shadowed, false, false, false };
+	sFrameStats stats = { 0 };
+	sFrame frame[2] = { 0 };
+	sCull cull = { 0 };
+	sWavefront wave = { 0 };
+	sOrder order = { 0 };
+	sBenchmark benchmark = { 0 };
+	bool benchmarkNext = false;
+	sCounters counters;
+	ijkTimer timer[1];
+	f64 ms = 0.0;
+	kstr const tracePath = options && options->trace[0] ? options->trace : "ijk-trace.json";
+	bool tracing = false;
+	ijkTimer clock[1];
+	ijkHistogram latency;
+	f64 inputTime = -1.0;
+	char text[128];
+	ijkMetricsFile metrics = { 0 };
+	ijkRingFile ring = { 0 };
+	ijkRecorder recorder = { 0 };
+	ui32 frameCount = 0;
+	ijkTimerInit(timer);
+	ijkTimerInit(clock);
+	ijkHistogramReset(&latency);
+	if (!fFrameCreate(frame + 0, width, height) || !fFrameCreate(frame + 1, width, height) ||
+		!fCullCreate(&cull, &viewport, &scene) || !fWavefrontCreate(&wave, width, height) ||
+		!fOrderCreate(&order, width, height))
+	{
+		fFrameRelease(frame + 0);
+		fFrameRelease(frame + 1);
+		fCullRelease(&cull);
+		fWavefrontRelease(&wave);
+		fOrderRelease(&order);
+		fSceneRelease(&scene);
+		return ijk_failcode(ijk_fail_allocation);
+	}
+
+	// output files open once nothing can fail, so every exit releases them
+	fMetricsCreate(&metrics, options ? options->metrics : "", "interactive");
+	fRingCreate(&ring, options ? options->ring : "", width, height);
+	fRecordCreate(&recorder, options ? options->record : "", width, height);
+
+	//------------------------------------
+	do
+	{
+		sFrame* const frame_curr = frame + frameIndex;
+		sFrame const* const frame_prev = frame + (frameIndex ^ 1);
+		bool const benchmarked = benchmarkNext;
+
+		// trace starts and stops between frames, and is written when stopped
+		if (settings.trace != tracing)
+			tracing = settings.trace = fTraceToggle(tracing, tracePath);
+		ijk_zone_begin("frame");
+		ijk_zone_begin("cull");
+		fCullUpdate(&cull, settings.cull, &viewport, &scene, &camera);
+		fOrderUpdate(&order, settings.order, settings.blockSize);
+		ijk_zone_end();
+		if (benchmarkNext)
+		{
+			// benchmark overwrites both frames, so there is nothing to reproject
+			fFrameBenchmark(frame + 0, frame + 1, &wave, &order, &viewport, &scene, &cull, &camera, &settings, &benchmark);
+			benchmarkNext = framePrev = false;
+		}
+
+		// frame is counted only while the performance row is shown or 
+		//	metrics are published
+		fCountersReset(&counters);
+		counters_bind(settings.hud || metrics.metrics ? &counters : 0);
+		ijkTimerStart(timer);
+		fFrameRender(frame_curr, framePrev ? frame_prev : 0, &wave, &order, &viewport, &scene, &cull, &camera, &settings, &stats);
+
+		//ijkConsoleDrawTestPatch();
+		ijkConsoleDrawFrame(console, frame_curr);
+		ms = ijkTimerElapsed(timer) * 1000.0;
+		fFrameCountChanged(frame_curr, framePrev ? frame_prev : 0);
+		counters_bind(0);
+		ijk_zone_begin("status");
+		if (settings.hud)
+			ijkConsoleDrawHud(console, &counters, ms, width);
+		ijkConsoleDrawStatus(console, &settings, &cull, &stats, &benchmark, &latency, height);
+		fflush(stdout);
+
+		// frame reflecting last input has been written and flushed; taken 
+		//	before publishing (recording may wait), and not after the 
+		//	benchmark, which would be all it measured
+		if (inputTime >= 0.0 && !benchmarked)
+			ijkHistogramRecord(&latency, (ui64)((ijkTimerElapsed(clock) - inputTime) * 1.0e6 + 0.5));
+		fMetricsPublish(&metrics, ms, ms > 0.0 ? 1000.0 / ms : 0.0, stats.rays, counters.count[counter_bytes]);
+		fRingPublish(&ring, frame_curr->color, frameCount);
+		fRecordFrame(&recorder, frame_curr->color, frameCount);
+		++frameCount;
+		ijk_zone_end();
+		ijk_zone_end();
+		frameIndex ^= 1;
+		framePrev = true;
+
+		// keys are read as pressed, so latency runs from the key rather 
+		//	than a line submitted after it; line breaks are skipped
+		ijk_zone_begin("input");
+		do
+			if (!ijk_issuccess(ijkConsoleGetKey(&key)))
+				key = EOF;
+		while (key == '\n' || key == '\r');
+		inputTime = ijkTimerElapsed(clock);
+		ijk_zone_end();
+	} while (ijkConsoleDrawInput(&camera, &settings, &benchmarkNext, key));
+	if (tracing)
+		fTraceToggle(tracing, tracePath);
+	if (latency.count)
+	{
+		// console is released on exit, so summary also goes to debugger
+		fLatencyFormat(text, &latency);
+		printf("%s \n", text);
+		dprintf("%s\n", text);
+	}
+	if (metrics.metrics)
+		ijkMetricsRelease(&metrics);
+	if (ring.ring)
+		ijkRingRelease(&ring);
+	fRecordClose(&recorder, options ? options->record : "");
+	//------------------------------------
+
+	fFrameRelease(frame + 0);
+	fFrameRelease(frame + 1);
+	fCullRelease(&cull);
+	fWavefrontRelease(&wave);
+	fOrderRelease(&order);
+	fSceneRelease(&scene);
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+// BATCH RENDERING
+
+// Frames per turn of the batch camera around the scene
+#define batch_turnFrames 120
+
+// Get distance from the origin to the middle of the scene along the 
+//	default view direction: the mean depth of its shapes
+ijk_inl f32 fBatchGetOrbit(sScene const* const scene)
+{
+	f64 depth = 0.0;
+	ui32 i;
+	ui32 const shapes = scene->numSpheres + scene->numCylinders;
+	for (i = 0; i < scene->numSpheres; ++i)
+		depth -= (f64)scene->location[scene->sphere[i].i_location].z;
+	for (i = 0; i < scene->numCylinders; ++i)
+		depth -= (f64)(scene->location[scene->cylinder[i].i_location_cap0].z + scene->location[scene->cylinder[i].i_location_cap1].z) * 0.5;
+	return (shapes && depth > 0.0 ? (f32)(depth / (f64)shapes) : 1.0f);
+}
+
+// Pose scene and camera for frame of batch animation
+//	-> camera circles the middle of the scene, looking at it, starting 
+//		from the default view at the origin; the first sphere bobs up and 
+//		down; poses depend only on the frame number, so every thread 
+//		renders the same frame identically
+//	-> only the first sphere moves, and it is set from the scene at rest, 
+//		so a worker's snapshot is copied once rather than every frame
+ijk_inl void fBatchAnimate(sScene* const scene, sCamera* const camera, sScene const* const scene_rest, f32 const orbit, ui32 const frame)
+{
+	extern f64 sin(f64);
+	float3_t const center = { 0.0f, 0.0f, -orbit };
+	f32 const angle = (f32)(frame % batch_turnFrames) * (2.0f * 3.14159265f / (f32)batch_turnFrames);
+	vec3f location;
+	float_t radius;
+
+	fCameraInit(camera, center, angle);
+	fCameraMove(camera, 0.0f, 0.0f, -orbit);
+	if (scene->numSpheres)
+	{
+		fSphereGet(scene_rest, 0, &location, &radius);
+		scene->location[scene->sphere[0].i_location].y = location.y + (float_t)sin((f64)angle * 3.0);
+	}
+}
+
+// Batch render state shared by workers and writer
+//	-> workers claim frames in order from 'next'; a finished frame's colors 
+//		go to slot (frame % slots), flagged with its number plus one; the 
+//		writer drains slots in frame order, and a worker more than 'slots' 
+//		frames ahead of the writer waits, so memory stays bounded
+//	-> frames before 'warmup' are rendered and written but not measured; 
+//		each measured frame's time is its render time on a worker plus its 
+//		encode and present time on the writer
+typedef struct sBatch_t
+{
+	sScene const* scene;		// Scene at rest, posed per frame by each worker
+	f32 orbit;					// Distance from camera to middle of scene
+	sViewport const* viewport;	// Viewport shared by all frames
+	sDrawSettings const* settings;	// Settings shared by all frames
+	ui32 frameFirst, count;		// First frame and number of frames
+	ui32 warmup;				// Frames rendered before measuring
+	ui32 slots;					// Finished frames held for writer
+	bool trace;					// Threads record profiler zones
+	bool perf;					// Threads measure stages with hardware counters
+	ijkConsoleColor* color;		// Colors per slot
+	f64* ms;					// Time per frame in milliseconds
+	ui32* rays;					// Primary rays per slot
+	i32 volatile* ready;		// Frame number plus one per slot when finished
+	i32 volatile next;			// Next frame to claim, relative to first
+	i32 volatile written;		// Frames written, relative to first
+} sBatch;
+
+// Batch worker state, each with its own scene and frame
+typedef struct sBatchWorker_t
+{
+	sBatch* batch;				// Shared state
+	sScene scene;				// Scene posed for current frame
+	sCamera camera;				// Camera posed for current frame
+	sFrame frame;				// Frame buffers
+	sCull cull;					// Culling for current frame
+	sWavefront wave;			// Wavefront queues
+	sOrder order;				// Traversal order
+	ijkThread thread;			// Thread running worker
+	ui64 rays;					// Primary rays traced in measured frames
+	f64 msRender;				// Time rendering measured frames
+	f64 msStage[wave_count];	// Time per wavefront stage in measured frames
+	sCounters counters;			// Hot-path counts in measured frames
+	sPerfStages perf;			// Hardware counts per stage in measured frames
+} sBatchWorker;
+
+// Allocate batch worker
+ijk_inl bool fBatchWorkerCreate(sBatchWorker* const worker, sBatch* const batch)
+{
+	ui16 const width = batch->viewport->width, height = batch->viewport->height;
+	worker->batch = batch;
+	if (!fSceneCreate(&worker->scene, batch->scene->numSpheres, batch->scene->numCylinders, batch->scene->numPointLights) ||
+		!fSceneCopy(&worker->scene, batch->scene) || !fFrameCreate(&worker->frame, width, height) || !fCullCreate(&worker->cull, batch->viewport, &worker->scene) ||
+		!fWavefrontCreate(&worker->wave, width, height) || !fOrderCreate(&worker->order, width, height))
+		return false;
+	fOrderUpdate(&worker->order, batch->settings->order, batch->settings->blockSize);
+	return true;
+}
+
+// Release batch worker
+ijk_inl void fBatchWorkerRelease(sBatchWorker* const worker)
+{
+	fFrameRelease(&worker->frame);
+	fCullRelease(&worker->cull);
+	fWavefrontRelease(&worker->wave);
+	fOrderRelease(&worker->order);
+	fSceneRelease(&worker->scene);
+}
+
+// Batch worker thread: render claimed frames until range is done
+ijk_inl iret fBatchWorkerRun(ptr const args)
+{
+	sBatchWorker* const worker = (sBatchWorker*)args;
+	sBatch* const batch = worker->batch;
+	ui32 const pixels = (ui32)batch->viewport->width * (ui32)batch->viewport->height;
+	ijkTimer timer[1];
+	sFrameStats stats;
+	ui32 f, slot, stage;
+
+	ijkTimerInit(timer);
+	if (batch->trace)
+		ijkProfilerThreadBegin("worker");
+	bool const measuring = batch->perf && fPerfStagesOpen(&worker->perf);
+	while ((f = (ui32)ijkThreadAtomicIncrement(&batch->next) - 1) < batch->count)
+	{
+		ijk_zone_begin("wait");
+		while (f - (ui32)ijkThreadAtomicLoad(&batch->written) >= batch->slots)
+			ijkThreadYield();
+		ijk_zone_end();
+
+		ijkTimerStart(timer);
+		counters_bind(f >= batch->warmup ? &worker->counters : 0);
+		perf_bind(measuring && f >= batch->warmup ? &worker->perf : 0);
+		ijk_zone_begin("animate");
+		fBatchAnimate(&worker->scene, &worker->camera, batch->scene, batch->orbit, batch->frameFirst + f);
+		ijk_zone_end();
+		ijk_zone_begin("cull");
+		fCullUpdate(&worker->cull, batch->settings->cull, batch->viewport, &worker->scene, &worker->camera);
+		ijk_zone_end();
+		fFrameRender(&worker->frame, 0, &worker->wave, &worker->order, batch->viewport, &worker->scene, &worker->cull, &worker->camera, batch->settings, &stats);
+		counters_bind(0);
+		perf_bind(0);
+		batch->ms[f] = ijkTimerElapsed(timer) * 1000.0;
+		if (f >= batch->warmup)
+		{
+			worker->rays += stats.rays;
+			worker->msRender += batch->ms[f];
+			for (stage = 0; stage < wave_count; ++stage)
+				worker->msStage[stage] += stats.msStage[stage];
+		}
+
+		slot = f % batch->slots;
+		batch->rays[slot] = stats.rays;
+		ijk_zone_begin("copy");
+		memcpy(batch->color + slot * pixels, worker->frame.color, pixels * sizeof(*worker->frame.color));
+		ijk_zone_end();
+		ijkThreadAtomicStore(batch->ready + slot, (i32)f + 1);
+	}
+	fPerfStagesClose(&worker->perf);
+	ijkProfilerThreadEnd();
+	return ijk_success;
+}
+
+// Write batch frame as text: header line, then one hex digit per pixel; 
+//	returns bytes written
+ijk_inl size_t fBatchWrite(FILE* const file, ijkConsoleColor const* const color, ui16 const width, ui16 const height, ui32 const frame)
+{
+	ui16 x, y;
+	ui32 i;
+
+	i32 const header = fprintf(file, "frame %u\n", frame);
+	for (y = 0, i = 0; y < height; ++y)
+	{
+		for (x = 0; x < width; ++x, ++i)
+			fputc("0123456789abcdef"[color[i] & 0xf], file);
+		fputc('\n', file);
+	}
+	return ((size_t)ijk_maximum(header, 0) + ((size_t)width + 1) * (size_t)height);
+}
+
+// Batch results
+//	-> everything but 'frames' covers measured frames only; times are 
+//		totals, and percentiles are of time per frame
+typedef struct sBatchResult_t
+{
+	ui32 frames;				// Frames rendered and written
+	ui32 measured;				// Frames measured, after warm-up
+	ui32 threads;				// Worker threads
+	ui32 cores;					// Cores used: worker threads, at most one per core
+	f64 seconds;				// Time from end of warm-up to last write
+	ui64 rays;					// Primary rays traced
+	ui64 bytes;					// Bytes encoded and presented
+	f64 msRender;				// Time rendering (all workers)
+	f64 msStage[wave_count];	// Time per wavefront stage (all workers)
+	f64 msEncode;				// Time encoding frames
+	f64 msPresent;				// Time presenting frames to sink
+	f64 msMean, msP50, msP99, msMax;	// Time per frame
+	f64 msScene;				// Time creating or loading scene
+	ui32 numSpheres, numCylinders;	// Shapes in scene
+	sCounters counters;			// Hot-path counts in measured frames (all threads)
+	sPerfStages perf;			// Hardware counts per stage in measured frames (all threads)
+} sBatchResult;
+
+// Compare frame times for sorting
+ijk_inl int fBatchCompareTime(void const* const lh, void const* const rh)
+{
+	f64 const ms_lh = *(f64 const*)lh, ms_rh = *(f64 const*)rh;
+	return ((ms_lh > ms_rh) - (ms_lh < ms_rh));
+}
+
+// Render frame range on worker threads, writing frames in order
+//	-> each worker poses its own copy of the scene per frame and renders 
+//		into its own buffers; the calling thread only writes, so output 
+//		order never depends on thread timing
+//	-> frames are written as text, or if 'encode' is set, encoded and 
+//		presented as a terminal stream (see encoding)
+ijk_inl iret ijkPlayerBatch(sOptions const* const options, bool const encode, sBatchResult* const result_out)
+{
+	ui16 const width = options ? options->width : 0, height = options ? options->height : 0;
+	f32 const viewHeight = 2.0f, viewDist = 3.0f;
+
+	ijkTimer timer[1], timer_write[1], clock[1];
+	iret status = ijk_success;
+	ui32 i, f, started, stage;
+	size_t size;
+	FILE* file = 0;
+	ijkMetricsFile metrics = { 0 };
+	ijkRingFile ring = { 0 };
+	ijkRecorder recorder = { 0 };
+
+	if (!options || !options->batch || !result_out || !ijk_issuccess(ijkTimerInit(timer)) || !ijk_issuccess(ijkTimerInit(timer_write)) || !ijk_issuccess(ijkTimerInit(clock)))
+		return ijk_failcode(ijk_fail_invalidparam);
+
+	sViewport viewport;
+	fViewportInit(&viewport, width, height, viewHeight, viewDist);
+
+	sScene scene = { 0 };
+	ijkTimerStart(timer);
+	if (!fOptionsCreateScene(options, &viewport, &scene))
+		return ijk_failcode(ijk_fail_allocation);
+	f64 const msScene = ijkTimerElapsed(timer) * 1000.0;
+
+	sDrawSettings settings = { engine_trace, 4, 0, cull_none, order_row, kernel_persp, kernel_shadowed, false, false, false };
+	settings.engine = options->engine == engine_reproject ? engine_trace : options->engine;
+	settings.cull = options->cull;
+
+	ui32 const threads = options->threads ? options->threads : ijkThreadGetCores();
+	ui32 const pixels = (ui32)width * (ui32)height;
+	ui32 const count = options->frameLast - options->frameFirst + 1;
+	sBatch batch = { &scene, fBatchGetOrbit(&scene), &viewport, &settings, options->frameFirst, count, ijk_minimum(options->warmup, count), threads * 2, options->trace[0] != 0, options->perf };
+	sBatchWorker* const worker = (sBatchWorker*)calloc(threads, sizeof(*worker));
+	byte* const buffer = encode ? (byte*)malloc(fFrameEncodeCapacity(width, height)) : 0;
+	batch.color = (ijkConsoleColor*)malloc((size_t)batch.slots * (size_t)pixels * sizeof(*batch.color));
+	batch.ms = (f64*)malloc((size_t)count * sizeof(*batch.ms));
+	batch.rays = (ui32*)calloc(batch.slots, sizeof(*batch.rays));
+	batch.ready = (i32 volatile*)calloc(batch.slots, sizeof(*batch.ready));
+	for (i = 0; worker && i < threads; ++i)
+		if (!fBatchWorkerCreate(worker + i, &batch))
+			break;
+	if (!worker || !batch.color || !batch.ms || !batch.rays || !batch.ready || i < threads || (encode && !buffer))
+		status = ijk_failcode(ijk_fail_allocation);
+	else if (options->path[0])
+		file = fFrameOpenSink(options->path, encode);
+	if (ijk_issuccess(status) && options->path[0] && !file)
+		status = ijk_failcode(ijk_fail_invalidparam);
+
+	//------------------------------------
+	if (ijk_issuccess(status))
+	{
+		// trace records every thread from the start, warm-up included
+		if (batch.trace)
+			batch.trace = fTraceToggle(false, options->trace);
+		fMetricsCreate(&metrics, options->metrics, "batch");
+		fRingCreate(&ring, options->ring, width, height);
+		fRecordCreate(&recorder, options->record, width, height);
+		ijkTimerStart(timer);
+		ijkTimerStart(clock);
+		for (started = 0; started < threads; ++started)
+			if (!ijk_issuccess(ijkThreadCreate(&worker[started].thread, fBatchWorkerRun, worker + started)))
+				break;
+
+		// no workers: claim every frame so nothing waits on them
+		if (!started)
+			batch.next = (i32)batch.count;
+		sBatchResult const result = { 0, 0, started, ijk_minimum(started, ijkThreadGetCores()) };
+		*result_out = result;
+		result_out->msScene = msScene;
+		result_out->numSpheres = scene.numSpheres;
+		result_out->numCylinders = scene.numCylinders;
+		bool const measuring = batch.perf && fPerfStagesOpen(&result_out->perf);
+		for (f = 0; started && f < batch.count; ++f)
+		{
+			ui32 const slot = f % batch.slots;
+			ijk_zone_begin("wait");
+			while (ijkThreadAtomicLoad(batch.ready + slot) != (i32)f + 1)
+				ijkThreadYield();
+			ijk_zone_end();
+
+			// write, or encode then present (one write and flush per frame)
+			counters_bind(f >= batch.warmup ? &result_out->counters : 0);
+			perf_bind(measuring && f >= batch.warmup ? &result_out->perf : 0);
+			ijkTimerStart(timer_write);
+			size = 0;
+			if (!encode && file)
+			{
+				ijk_zone_begin("write");
+				size = fBatchWrite(file, batch.color + slot * pixels, width, height, batch.frameFirst + f);
+				ijk_zone_end();
+			}
+			else if (encode)
+			{
+				ijk_zone_begin("encode");
+				perf_begin(perf_encode);
+				size = fFrameEncode(buffer, batch.color + slot * pixels, width, height);
+				perf_end(perf_encode);
+				ijk_zone_end();
+				f64 const msEncode = ijkTimerLap(timer_write) * 1000.0;
+				ijk_zone_begin("present");
+				perf_begin(perf_present);
+				if (file)
+				{
+					fwrite(buffer, 1, size, file);
+					fflush(file);
+					counters_add(counter_bytes, size);
+					counters_add(counter_syscalls, 2);
+				}
+				perf_end(perf_present);
+				ijk_zone_end();
+				f64 const msPresent = ijkTimerLap(timer_write) * 1000.0;
+				batch.ms[f] += msEncode + msPresent;
+				if (f >= batch.warmup)
+				{
+					result_out->bytes += size;
+					result_out->msEncode += msEncode;
+					result_out->msPresent += msPresent;
+				}
+			}
+
+			// slot is published before it is released to workers; rate is 
+			//	frames written over time since writing started
+			fMetricsPublish(&metrics, batch.ms[f], (f64)(f + 1) / ijk_maximum(ijkTimerElapsed(clock), 1.0e-9), batch.rays[slot], size);
+			fRingPublish(&ring, batch.color + slot * pixels, batch.frameFirst + f);
+			fRecordFrame(&recorder, batch.color + slot * pixels, batch.frameFirst + f);
+			ijkThreadAtomicStore(&batch.written, (i32)f + 1);
+			if (f + 1 == batch.warmup)
+				ijkTimerStart(timer);
+		}
+		counters_bind(0);
+		perf_bind(0);
+		fPerfStagesClose(&result_out->perf);
+		for (i = 0; i < started; ++i)
+			ijkThreadJoin(&worker[i].thread);
+		if (file)
+			fflush(file);
+		if (batch.trace)
+			fTraceToggle(true, options->trace);
+		if (metrics.metrics)
+			ijkMetricsRelease(&metrics);
+		if (ring.ring)
+			ijkRingRelease(&ring);
+		fRecordClose(&recorder, options->record);
+
+		result_out->frames = f;
+		result_out->measured = f > batch.warmup ? f - batch.warmup : 0;
+		result_out->seconds = result_out->measured ? ijkTimerElapsed(timer) : 0.0;
+		for (i = 0; i < started; ++i)
+		{
+			fCountersMerge(&result_out->counters, &worker[i].counters);
+			fPerfStagesMerge(&result_out->perf, &worker[i].perf);
+			result_out->rays += worker[i].rays;
+			result_out->msRender += worker[i].msRender;
+			for (stage = 0; stage < wave_count; ++stage)
+				result_out->msStage[stage] += worker[i].msStage[stage];
+		}
+		if (result_out->measured)
+		{
+			f64* const ms = batch.ms + batch.warmup;
+			ui32 const n = result_out->measured;
+			for (i = 0; i < n; ++i)
+				result_out->msMean += ms[i];
+			result_out->msMean /= (f64)n;
+			qsort(ms, n, sizeof(*ms), fBatchCompareTime);
+			result_out->msP50 = ms[(n - 1) / 2];
+			result_out->msP99 = ms[(ui32)((f64)(n - 1) * 0.99 + 0.5)];
+			result_out->msMax = ms[n - 1];
+		}
+		if (!started)
+			status = ijk_failcodespec(ijk_fail_thread_create);
+	}
+	//------------------------------------
+
+	if (file && file != stdout)
+		fclose(file);
+	for (i = 0; worker && i < threads; ++i)
+		fBatchWorkerRelease(worker + i);
+	free(worker);
+	free(buffer);
+	free(batch.color);
+	free(batch.ms);
+	free(batch.rays);
+	free((ptr)batch.ready);
+	fSceneRelease(&scene);
+	return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// REPLAY
+
+// Replay results
+typedef struct sReplayResult_t
+{
+	ui16 width, height;			// Dimensions of recorded frames
+	ui32 frames;				// Frames replayed
+	ui32 keyframes;				// Keyframes in recording
+	f64 seconds;				// Time replaying (decode, encode and present)
+	f64 msDecode, msEncode, msPresent;	// Time per step (totals)
+	ui64 recorded;				// Bytes of recording replayed
+	ui64 bytes;					// Bytes encoded for sink
+} sReplayResult;
+
+// Replay recording as fast as the output path allows: frames are decoded, 
+//	then drawn to the console if given, or else encoded as changes from 
+//	the frame before and written to the sink given with "--out" (only 
+//	encoded if there is none)
+ijk_inl iret ijkPlayerReplay(ijkConsole const* const console, sOptions const* const options, sReplayResult* const result_out)
+{
+	sReplayResult const reset = { 0 };
+	ijkPlayback playback = { 0 };
+	ijkTimer timer[1];
+	ijkConsoleColor* colors = 0, * color, * color_prev, * swap;
+	byte* cells = 0, * buffer = 0;
+	FILE* file = 0;
+	size_t size;
+	ui32 i, count;
+	iret status;
+
+	if (!options || !options->replay[0] || !result_out)
+		return ijk_failcode(ijk_fail_invalidparam);
+	*result_out = reset;
+	status = ijkPlaybackOpen(&playback, options->replay);
+	if (!ijk_issuccess(status))
+		return status;
+	count = (ui32)playback.header.width * (ui32)playback.header.height;
+	result_out->width = playback.header.width;
+	result_out->height = playback.header.height;
+	result_out->keyframes = playback.header.keyframes;
+
+	cells = (byte*)malloc(count);
+	colors = (ijkConsoleColor*)malloc((size_t)count * 2 * sizeof(*colors));
+	buffer = console ? 0 : (byte*)malloc(fFrameEncodeCapacity(playback.header.width, playback.header.height));
+	if (!cells || !colors || (!console && !buffer))
+		status = ijk_failcode(ijk_fail_allocation);
+	else if (!console && options->path[0])
+	{
+		file = fFrameOpenSink(options->path, true);
+		if (!file)
+			status = ijk_failcode(ijk_fail_invalidparam);
+		else
+			setvbuf(file, 0, _IONBF, 0);
+	}
+	//------------------------------------
+
+	if (ijk_issuccess(status))
+	{
+		// first frame is encoded whole
+		color = colors;
+		color_prev = colors + count;
+		memset(color_prev, 0xff, (size_t)count * sizeof(*color_prev));
+		ijkTimerInit(timer);
+		ijkTimerStart(timer);
+		while (ijk_issuccess(status = ijkPlaybackNext(&playback, cells, 0)))
+		{
+			for (i = 0; i < count; ++i)
+				color[i] = (ijkConsoleColor)cells[i];
+			result_out->msDecode += ijkTimerLap(timer) * 1000.0;
+			if (console)
+			{
+				sFrame frame = { 0 };
+				frame.width = playback.header.width;
+				frame.height = playback.header.height;
+				frame.color = color;
+				ijkConsoleDrawFrame(console, &frame);
+				fflush(stdout);
+			}
+			else
+			{
+				size = fFrameEncodeDelta(buffer, color, color_prev, playback.header.width, playback.header.height);
+				result_out->msEncode += ijkTimerLap(timer) * 1000.0;
+				if (size && file)
+				{
+					fwrite(buffer, 1, size, file);
+					fflush(file);
+				}
+				result_out->bytes += size;
+			}
+			result_out->msPresent += ijkTimerLap(timer) * 1000.0;
+			++result_out->frames;
+			swap = color_prev;
+			color_prev = color;
+			color = swap;
+		}
+		if (status == ijk_failcodespec(ijk_fail_recording_end))
+			status = ijk_success;
+		result_out->seconds = (result_out->msDecode + result_out->msEncode + result_out->msPresent) * 0.001;
+		result_out->recorded = (ui64)(playback.cursor - (byte const*)playback.map.data);
+	}
+	//------------------------------------
+
+	if (file && file != stdout)
+		fclose(file);
+	free(buffer);
+	free(colors);
+	free(cells);
+	ijkPlaybackRelease(&playback);
+	return status;
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkPlayerMain(kstr const args)
+{
+	iret status = -1;
+	i32 i = -1;
+
+	// data structures for management
+	ijkConsole console[1] = { 0 };
+	sOptions options[1];
+	sBatchResult result[1] = { 0 };
+	sReplayResult replay[1] = { 0 };
 
 	// constants
+	fOptionsParse(options, args);
 	status = ijkConsoleCreateMain(console);
-	status = ijkConsoleDraw(console);
+	if (options->replay[0])
+	{
+		status = ijkPlayerReplay(options->path[0] ? 0 : console, options, replay);
+		if (!options->path[0])
+		{
+			ijkConsoleResetColor();
+			ijkConsoleClear();
+		}
+		if (ijk_issuccess(status))
+			printf("replay: %u frames (%u keyframes) in %.3f s, %.2f fps, %.1f recorded bytes per frame \n",
+				replay->frames, replay->keyframes, replay->seconds, (f64)replay->frames / replay->seconds,
+				(f64)replay->recorded / (f64)ijk_maximum(replay->frames, 1));
+		else
+			printf("replay: failed \n");
+		printf("[enter] exit \n");
+		getchar();
+	}
+	else if (options->batch)
+	{
+		status = ijkPlayerBatch(options, false, result);
+		if (options->load[0] && ijk_issuccess(status))
+			printf("scene: '%s', %u spheres, %u cylinders, loaded in %.3f ms \n",
+				options->load, result->numSpheres, result->numCylinders, result->msScene);
+		else if (options->generate)
+			printf("scene: %s, %u spheres, %u cylinders, seed %u, coverage %.2f, overlap %.2f \n",
+				sceneLayoutName[options->scene.layout], options->scene.numSpheres, options->scene.numCylinders,
+				options->scene.seed, (f64)options->scene.coverage, (f64)options->scene.overlap);
+		if (ijk_issuccess(status))
+			printf("batch: %u frames in %.3f s, %.2f fps, %.2f fps per core (%u threads, %u cores), %.3f Mrays/s \n",
+				result->measured, result->seconds, (f64)result->measured / result->seconds,
+				(f64)result->measured / result->seconds / (f64)result->cores, result->threads, result->cores,
+				(f64)result->rays * 1.0e-6 / result->seconds);
+		else
+			printf("batch: failed \n");
+		printf("[enter] exit \n");
+		getchar();
+	}
+	else
+		status = ijkConsoleDraw(console, options);
 	status = ijkConsoleReleaseMain(console);
 
 	// done
@@ -246,4 +3812,811 @@ iret ijkPlayerMain()
 }
 
 
+//-----------------------------------------------------------------------------
+
+// Frames measured and warmed up when benchmark is not given a range
+#define bench_frames 64
+#define bench_warmup 8
+
+// Write number to JSON, or null if not available
+ijk_inl void fBenchWriteNumber(FILE* const file, kstr const name, f64 const value, bool const available, kstr const next)
+{
+	if (available)
+		fprintf(file, "\"%s\": %.6g%s", name, value, next);
+	else
+		fprintf(file, "\"%s\": null%s", name, next);
+}
+
+// Write scaled counters to JSON as another member, if compiled in
+ijk_inl void fBenchWriteCounters(FILE* const file, sCounters const* const counters, f64 const scale)
+{
+#ifdef IJK_PLAYER_COUNTERS
+	ui32 i;
+	fprintf(file, ",\n  \"counters_per_frame\": { ");
+	for (i = 0; i < counter_count; ++i)
+		fBenchWriteNumber(file, counterName[i], (f64)counters->count[i] * scale, true, i + 1 < counter_count ? ", " : " }");
+#endif	// IJK_PLAYER_COUNTERS
+}
+
+// Write scaled hardware counts per stage to JSON as another member
+//	-> every stage keeps its timer; counters not available on every thread
+//		are null, and the source is "timer" if none were
+ijk_inl void fBenchWritePerf(FILE* const file, sPerfStages const* const stages, f64 const ms[perf_stageCount], bool const measured[perf_stageCount], f64 const scale)
+{
+	ui64 const* count;
+	ui32 i, j;
+	bool const any = fPerfStagesAny(stages);
+	bool const ipc = stages->available[ijkPerfCounter_cycles] && stages->available[ijkPerfCounter_instructions];
+
+	fprintf(file, ",\n  \"hardware_per_frame\": { \"source\": \"%s\", \"stages\": {", any ? "counters" : "timer");
+	for (i = 0; i < perf_stageCount; ++i)
+	{
+		count = stages->count[i];
+		fprintf(file, "%s\n    \"%s\": { ", i ? "," : "", perfStageName[i]);
+		fBenchWriteNumber(file, "ms", ms[i] * scale, measured[i], ", ");
+		for (j = 0; j < ijkPerfCounter_count; ++j)
+			fBenchWriteNumber(file, perfCounterName[j], (f64)count[j] * scale, measured[i] && stages->available[j], ", ");
+		fBenchWriteNumber(file, "ipc", count[ijkPerfCounter_cycles] ? (f64)count[ijkPerfCounter_instructions] / (f64)count[ijkPerfCounter_cycles] : 0.0,
+			measured[i] && ipc && count[ijkPerfCounter_cycles], " }");
+	}
+	fprintf(file, "\n  } }");
+}
+
+
+//-----------------------------------------------------------------------------
+
+// Inputs per microbenchmark pass (few enough to stay in cache, so cases 
+//	measure arithmetic rather than memory)
+#define micro_count 1024
+
+// Shapes of each type that rays are tested against
+#define micro_shapes 4
+
+// Shortest measurement per microbenchmark case in seconds; passes double 
+//	until it is reached
+#define micro_seconds 0.05
+
+// Microbenchmark inputs and outputs
+//	-> inputs are drawn once from the seed; each case writes one result per 
+//		operation, and the outputs are summed into a checksum after timing, 
+//		so the work cannot be dropped as dead but no dependency is added 
+//		between operations
+//	-> rays share an origin like primary rays and are aimed near the first 
+//		few shapes of each type, so some hit and some miss
+typedef struct sMicro_t
+{
+	sScene const* scene;		// Scene with shapes to test
+	ui32 count;					// Inputs per pass
+	vec4f* v4_lh, * v4_rh;		// Vector inputs widened to 4D ('w' zero)
+	vec4f* v4_out;				// Vector results (4D)
+	vec3f* v_lh, * v_rh;		// Vector inputs
+	vec3f* v_out;				// Vector results
+	vec3fStream s_lh, s_rh;		// Vector inputs as streams
+	vec3fStream s_out;			// Vector results as streams
+	sRay* ray;					// Rays for scalar tests
+	vec3fStream direction;		// Ray directions as streams
+	floatv_t lenSq;				// Ray squared direction lengths
+	floatv_t f_out;				// Scalar results (one per ray and shape)
+	ptr data;					// Storage for all of the above
+} sMicro;
+
+// Microbenchmark case: runs one pass over inputs
+typedef void(*fMicroCase)(sMicro const* const micro);
+
+// Draw value in [-1, 1) from generator state (xorshift)
+ijk_inl float_t fMicroRandom(ui32* const state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return ((float_t)(*state >> 8) * (2.0f / 16777216.0f) - 1.0f);
+}
+
+// Allocate microbenchmark data and draw inputs from seed
+ijk_inl bool fMicroCreate(sMicro* const micro, sScene const* const scene, ui32 const seed)
+{
+	vec3f location, location_cap1, target;
+	float_t radius;
+	ui32 i, k, state = seed * 0x9e3779b9u + 0x7f4a7c15u;
+	ui32 const count = micro_count, spheres = ijk_minimum(scene->numSpheres, micro_shapes), cylinders = ijk_minimum(scene->numCylinders, micro_shapes);
+	ui32 const targets = spheres + cylinders;
+	size_t const size = (size_t)count * (3 * sizeof(vec4f) + 3 * sizeof(vec3f) + sizeof(sRay) + (13 + micro_shapes) * sizeof(float_t));
+	byte* data;
+
+	if (!micro || micro->data || !state)
+		return false;
+	data = (byte*)_aligned_malloc(size, sizeof(vec4f));
+	if (!data)
+		return false;
+	memset(data, 0, size);
+
+	// 4D vectors first so they keep the allocation's alignment (malloc 
+	//	only guarantees 8 bytes on 32-bit targets)
+	micro->scene = scene;
+	micro->count = count;
+	micro->data = data;
+	micro->v4_lh = (vec4f*)data;
+	micro->v4_rh = micro->v4_lh + count;
+	micro->v4_out = micro->v4_rh + count;
+	micro->v_lh = (vec3f*)(micro->v4_out + count);
+	micro->v_rh = micro->v_lh + count;
+	micro->v_out = micro->v_rh + count;
+	micro->ray = (sRay*)(micro->v_out + count);
+	micro->s_lh.x = (floatv_t)(micro->ray + count);
+	micro->s_lh.y = micro->s_lh.x + count;
+	micro->s_lh.z = micro->s_lh.y + count;
+	micro->s_rh.x = micro->s_lh.z + count;
+	micro->s_rh.y = micro->s_rh.x + count;
+	micro->s_rh.z = micro->s_rh.y + count;
+	micro->s_out.x = micro->s_rh.z + count;
+	micro->s_out.y = micro->s_out.x + count;
+	micro->s_out.z = micro->s_out.y + count;
+	micro->direction.x = micro->s_out.z + count;
+	micro->direction.y = micro->direction.x + count;
+	micro->direction.z = micro->direction.y + count;
+	micro->lenSq = micro->direction.z + count;
+	micro->f_out = micro->lenSq + count;
+
+	for (i = 0; i < count; ++i)
+	{
+		vec3fInit(micro->v_lh[i].v, fMicroRandom(&state), fMicroRandom(&state), fMicroRandom(&state));
+		vec3fInit(micro->v_rh[i].v, fMicroRandom(&state), fMicroRandom(&state), fMicroRandom(&state));
+		vec4fInit3(micro->v4_lh + i, micro->v_lh[i].v, 0.0f);
+		vec4fInit3(micro->v4_rh + i, micro->v_rh[i].v, 0.0f);
+		micro->s_lh.x[i] = micro->v_lh[i].x;
+		micro->s_lh.y[i] = micro->v_lh[i].y;
+		micro->s_lh.z[i] = micro->v_lh[i].z;
+		micro->s_rh.x[i] = micro->v_rh[i].x;
+		micro->s_rh.y[i] = micro->v_rh[i].y;
+		micro->s_rh.z[i] = micro->v_rh[i].z;
+
+		// aim at a random point around one of the shapes tested
+		k = targets ? i % targets : 0;
+		radius = 0.5f;
+		vec3fInit(location.v, 0.0f, 0.0f, -1.0f);
+		if (k < spheres)
+			fSphereGet(scene, k, &location, &radius);
+		else if (k - spheres < cylinders)
+		{
+			fCylinderGet(scene, k - spheres, &location, &location_cap1, &radius);
+			vec3fLerp(location.v, location.v, location_cap1.v, 0.5f);
+			radius += vec3fDist(location.v, location_cap1.v);
+		}
+		vec3fInit(target.v, fMicroRandom(&state), fMicroRandom(&state), fMicroRandom(&state));
+		vec3fMad(target.v, location.v, target.v, radius * 2.0f);
+		micro->ray[i].origin = vec3f0;
+		micro->ray[i].direction = target;
+		micro->direction.x[i] = target.x;
+		micro->direction.y[i] = target.y;
+		micro->direction.z[i] = target.z;
+		micro->lenSq[i] = vec3fLenSq(target.v);
+	}
+	return true;
+}
+
+// Release microbenchmark data
+ijk_inl bool fMicroRelease(sMicro* const micro)
+{
+	if (!micro || !micro->data)
+		return false;
+	_aligned_free(micro->data);
+	micro->data = 0;
+	return true;
+}
+
+// Clear microbenchmark outputs
+ijk_inl void fMicroClear(sMicro const* const micro)
+{
+	size_t const count = micro->count;
+	memset(micro->v4_out, 0, count * sizeof(*micro->v4_out));
+	memset(micro->v_out, 0, count * sizeof(*micro->v_out));
+	memset(micro->s_out.x, 0, count * 3 * sizeof(float_t));
+	memset(micro->f_out, 0, count * micro_shapes * sizeof(float_t));
+}
+
+// Sum microbenchmark outputs, counting ray results that hit
+ijk_inl f64 fMicroChecksum(sMicro const* const micro, ui32* const hits_out)
+{
+	f64 sum = 0.0;
+	ui32 i;
+	*hits_out = 0;
+	for (i = 0; i < micro->count; ++i)
+		sum += (f64)micro->v4_out[i].x + (f64)micro->v4_out[i].y + (f64)micro->v4_out[i].z + (f64)micro->v4_out[i].w +
+			(f64)micro->v_out[i].x + (f64)micro->v_out[i].y + (f64)micro->v_out[i].z +
+			(f64)micro->s_out.x[i] + (f64)micro->s_out.y[i] + (f64)micro->s_out.z[i];
+	for (i = 0; i < micro->count * micro_shapes; ++i)
+	{
+		sum += (f64)micro->f_out[i];
+		*hits_out += (micro->f_out[i] > 0.0f);
+	}
+	return sum;
+}
+
+// Cases: scalar vector operations
+ijk_inl void fMicroVec3fDot(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		micro->f_out[i] = vec3fDot(micro->v_lh[i].v, micro->v_rh[i].v);
+}
+
+ijk_inl void fMicroVec3fLenSq(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		micro->f_out[i] = vec3fLenSq(micro->v_lh[i].v);
+}
+
+ijk_inl void fMicroVec3fLen(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		micro->f_out[i] = vec3fLen(micro->v_lh[i].v);
+}
+
+ijk_inl void fMicroVec3fUnit(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		vec3fUnit(micro->v_out[i].v, micro->v_lh[i].v);
+}
+
+ijk_inl void fMicroVec3fUnitFast(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		vec3fUnitFast(micro->v_out[i].v, micro->v_lh[i].v);
+}
+
+// Cases: 4-wide vector operations
+ijk_inl void fMicroVec4fDot(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		micro->f_out[i] = vec4fDot(micro->v4_lh + i, micro->v4_rh + i);
+}
+
+ijk_inl void fMicroVec4fLen(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		micro->f_out[i] = vec4fLen(micro->v4_lh + i);
+}
+
+ijk_inl void fMicroVec4fUnit(sMicro const* const micro)
+{
+	ui32 i;
+	for (i = 0; i < micro->count; ++i)
+		vec4fUnit(micro->v4_out + i, micro->v4_lh + i);
+}
+
+// Cases: stream operations
+ijk_inl void fMicroStreamDot(sMicro const* const micro)
+{
+	vec3fStreamDot(micro->f_out, &micro->s_lh, &micro->s_rh, micro->count);
+}
+
+ijk_inl void fMicroStreamLenSq(sMicro const* const micro)
+{
+	vec3fStreamLenSq(micro->f_out, &micro->s_lh, micro->count);
+}
+
+ijk_inl void fMicroStreamUnit(sMicro const* const micro)
+{
+	vec3fStreamUnit(&micro->s_out, &micro->s_lh, micro->count);
+}
+
+// Cases: ray tests, every ray against each shape tested
+ijk_inl void fMicroRayTestSphere(sMicro const* const micro)
+{
+	sRecord hit;
+	ui32 i, s;
+	ui32 const shapes = ijk_minimum(micro->scene->numSpheres, micro_shapes);
+	floatv_t out = micro->f_out;
+	for (s = 0; s < shapes; ++s)
+		for (i = 0; i < micro->count; ++i, ++out)
+			*out = fRayTestSphere(micro->ray + i, micro->scene, s, &hit) ? hit.dist : -1.0f;
+}
+
+ijk_inl void fMicroRayTestCylinder(sMicro const* const micro)
+{
+	sRecord hit;
+	ui32 i, s;
+	ui32 const shapes = ijk_minimum(micro->scene->numCylinders, micro_shapes);
+	floatv_t out = micro->f_out;
+	for (s = 0; s < shapes; ++s)
+		for (i = 0; i < micro->count; ++i, ++out)
+			*out = fRayTestCylinderFinite(micro->ray + i, micro->scene, s, &hit) ? hit.dist : -1.0f;
+}
+
+// Case: sphere test over ray streams sharing an origin, as the wavefront 
+//	intersect stage runs it
+ijk_inl void fMicroStreamTestSphere(sMicro const* const micro)
+{
+	vec3f location;
+	float_t radius;
+	ui32 i, s;
+	ui32 const shapes = ijk_minimum(micro->scene->numSpheres, micro_shapes);
+	floatv_t out = micro->f_out;
+	for (s = 0; s < shapes; ++s)
+	{
+		fSphereGet(micro->scene, s, &location, &radius);
+		float_t const c = vec3fLenSq(location.v) - radius * radius;
+		for (i = 0; i < micro->count; ++i, ++out)
+		{
+			float_t const a = micro->lenSq[i];
+			float_t const b = -(micro->direction.x[i] * location.x + micro->direction.y[i] * location.y + micro->direction.z[i] * location.z);
+			float_t const disc = b * b - a * c;
+			float_t dist = -1.0f;
+			if (disc >= 0.0f && fIsNonZero(a))
+			{
+				float_t const root = fSqrt(disc), aInv = 1.0f / a;
+				dist = (-b - root) * aInv;
+				if (dist < ray_distMin)
+					dist = (-b + root) * aInv;
+				if (dist < ray_distMin)
+					dist = -1.0f;
+			}
+			*out = dist;
+		}
+	}
+}
+
+// Run microbenchmark case, doubling passes until the measurement is long 
+//	enough; returns passes in the measurement
+ijk_inl ui32 fMicroMeasure(sMicro const* const micro, fMicroCase const run, ijkTimer* const timer, f64* const seconds_out, ui64* const cycles_out)
+{
+	ui32 passes, n;
+	ui64 cycles;
+
+	fMicroClear(micro);
+	run(micro);
+	for (passes = 1; ; passes *= 2)
+	{
+		cycles = ijkTimerCycles();
+		ijkTimerStart(timer);
+		for (n = 0; n < passes; ++n)
+			run(micro);
+		*seconds_out = ijkTimerElapsed(timer);
+		*cycles_out = ijkTimerCycles() - cycles;
+		if (*seconds_out >= micro_seconds || passes >= 0x40000000)
+			break;
+	}
+	return passes;
+}
+
+// Run microbenchmarks of vector operations and ray tests, reporting JSON
+//	-> each case reports time and cycles per operation; cycles are read 
+//		from the processor's time-stamp counter, which counts at its rated 
+//		rather than current clock, and are null if it has none
+ijk_inl iret fBenchMicro(sOptions const* const options)
+{
+	// cases: name, variant, shape type tested (none for vector cases)
+	struct { kstr name, variant; ui32 type; fMicroCase run; } const cases[] = {
+		{ "vec3fDot", "scalar", shape_none, fMicroVec3fDot },
+		{ "vec3fLenSq", "scalar", shape_none, fMicroVec3fLenSq },
+		{ "vec3fLen", "scalar", shape_none, fMicroVec3fLen },
+		{ "vec3fUnit", "scalar", shape_none, fMicroVec3fUnit },
+		{ "vec3fUnitFast", "scalar", shape_none, fMicroVec3fUnitFast },
+		{ "vec4fDot", "simd", shape_none, fMicroVec4fDot },
+		{ "vec4fLen", "simd", shape_none, fMicroVec4fLen },
+		{ "vec4fUnit", "simd", shape_none, fMicroVec4fUnit },
+		{ "vec3fStreamDot", "stream", shape_none, fMicroStreamDot },
+		{ "vec3fStreamLenSq", "stream", shape_none, fMicroStreamLenSq },
+		{ "vec3fStreamUnit", "stream", shape_none, fMicroStreamUnit },
+		{ "fRayTestSphere", "scalar", shape_sphere, fMicroRayTestSphere },
+		{ "fRayTestSphere", "stream", shape_sphere, fMicroStreamTestSphere },
+		{ "fRayTestCylinderFinite", "scalar", shape_cylinder, fMicroRayTestCylinder },
+	};
+#if (defined vec_simd_sse)
+	kstr const simd = "sse";
+#elif (defined vec_simd_neon)
+	kstr const simd = "neon";
+#else	// !SIMD
+	kstr const simd = "none";
+#endif	// SIMD
+
+	ijkTimer timer[1];
+	sMicro micro[1] = { 0 };
+	sScene scene = { 0 };
+	sViewport viewport;
+	f64 seconds, checksum;
+	ui64 cycles, ops;
+	ui32 i, passes, hits, shapes;
+
+	if (!options || !ijk_issuccess(ijkTimerInit(timer)))
+		return ijk_failcode(ijk_fail_invalidparam);
+	fViewportInit(&viewport, options->width, options->height, 2.0f, 3.0f);
+	if (!fOptionsCreateScene(options, &viewport, &scene))
+		return ijk_failcode(ijk_fail_allocation);
+	if (!fMicroCreate(micro, &scene, options->scene.seed))
+	{
+		fSceneRelease(&scene);
+		return ijk_failcode(ijk_fail_allocation);
+	}
+
+	printf("{\n");
+	printf("  \"micro\": { \"count\": %u, \"seed\": %u, \"simd\": \"%s\", \"spheres\": %u, \"cylinders\": %u },\n",
+		micro->count, options->scene.seed, simd,
+		ijk_minimum(scene.numSpheres, micro_shapes), ijk_minimum(scene.numCylinders, micro_shapes));
+	printf("  \"cases\": [");
+	for (i = 0; i < ijk_arrlen(cases); ++i)
+	{
+		shapes = cases[i].type == shape_sphere ? scene.numSpheres : cases[i].type == shape_cylinder ? scene.numCylinders : 1;
+		if (!shapes)
+			continue;
+		passes = fMicroMeasure(micro, cases[i].run, timer, &seconds, &cycles);
+		checksum = fMicroChecksum(micro, &hits);
+		ops = (ui64)passes * (ui64)micro->count * (ui64)ijk_minimum(shapes, micro_shapes);
+		printf("%s\n    { \"name\": \"%s\", \"variant\": \"%s\", ", i ? "," : "", cases[i].name, cases[i].variant);
+		fBenchWriteNumber(stdout, "ns_per_op", seconds * 1.0e9 / (f64)ops, true, ", ");
+		fBenchWriteNumber(stdout, "ops_per_cycle", (f64)ops / (f64)cycles, cycles != 0, ", ");
+		fBenchWriteNumber(stdout, "hit_rate", (f64)hits * (f64)passes / (f64)ops, cases[i].type != shape_none, ", ");
+		fBenchWriteNumber(stdout, "checksum", checksum, true, " }");
+	}
+	printf("\n  ]\n}\n");
+
+	fMicroRelease(micro);
+	fSceneRelease(&scene);
+	return ijk_success;
+}
+
+// Measure largest error of each fast math function against its precise 
+//	reference over every positive normal float, reporting JSON
+//	-> the interactive benchmark samples every 257th input; this is the 
+//		full sweep, so it takes seconds per function
+ijk_inl iret fBenchUlp(sOptions const* const options)
+{
+	struct { kstr name, reference; ui32(*measure)(ui32 const step); } const cases[] = {
+		{ "fRecipFast", "1 / s", fRecipFastErrorULP },
+		{ "fSqrtFast", "fSqrt", fSqrtFastErrorULP },
+		{ "fSqrtInvFast", "1 / fSqrt", fSqrtInvFastErrorULP },
+	};
+	ijkTimer timer[1];
+	ui32 i, ulp;
+
+	if (!options || !ijk_issuccess(ijkTimerInit(timer)))
+		return ijk_failcode(ijk_fail_invalidparam);
+
+	printf("{\n");
+	printf("  \"ulp\": { \"step\": 1 },\n");
+	printf("  \"functions\": [");
+	for (i = 0; i < ijk_arrlen(cases); ++i)
+	{
+		ijkTimerStart(timer);
+		ulp = cases[i].measure(1);
+		printf("%s\n    { \"name\": \"%s\", \"reference\": \"%s\", \"max_ulp\": %u, ", i ? "," : "", cases[i].name, cases[i].reference, ulp);
+		fBenchWriteNumber(stdout, "seconds", ijkTimerLap(timer), true, " }");
+	}
+	printf("\n  ]\n}\n");
+	return ijk_success;
+}
+
+
+
+//-----------------------------------------------------------------------------
+
+// Output benchmark patterns
+typedef enum eOutputPattern_t
+{
+	output_solid,				// Whole frame one color, changing every frame
+	output_patch,				// Every color along diagonals, shifting every frame (worst case)
+	output_noise,				// Random color per cell every frame
+	output_gradient,			// Bands of color scrolling one cell per frame
+	output_patternCount
+} eOutputPattern;
+
+// Output benchmark presentation strategies
+typedef enum eOutputPresent_t
+{
+	output_console,				// Console calls per cell, as drawn interactively
+	output_ansi,				// Full frame encoded, one write
+	output_delta,				// Changed cells encoded, one write
+	output_presentCount
+} eOutputPresent;
+
+static kstr const outputPatternName[output_patternCount] = { "solid", "patch", "noise", "gradient" };
+static kstr const outputPresentName[output_presentCount] = { "console", "ansi", "delta" };
+
+// Width of color bands in scrolling gradient pattern
+#define output_bandWidth 4
+
+// Fill frame colors with pattern
+ijk_inl void fOutputFill(ijkConsoleColor* const color, ui16 const width, ui16 const height, eOutputPattern const pattern, ui32 const frame, ui32* const state)
+{
+	ui16 x, y;
+	ui32 i;
+	for (y = 0, i = 0; y < height; ++y)
+	{
+		for (x = 0; x < width; ++x, ++i)
+		{
+			switch (pattern)
+			{
+			case output_solid:
+				color[i] = (ijkConsoleColor)(frame & 0xf);
+				break;
+			case output_patch:
+				color[i] = (ijkConsoleColor)((x + y + frame) & 0xf);
+				break;
+			case output_noise:
+				*state ^= *state << 13;
+				*state ^= *state >> 17;
+				*state ^= *state << 5;
+				color[i] = (ijkConsoleColor)(*state >> 28);
+				break;
+			default:
+				color[i] = (ijkConsoleColor)(((x + frame) / output_bandWidth) & 0xf);
+				break;
+			}
+		}
+	}
+}
+
+// Output benchmark result per pattern and strategy
+typedef struct sOutputResult_t
+{
+	f64 seconds;				// Time presenting measured frames
+	ui64 bytes;					// Bytes emitted
+	ui64 calls;					// Console calls and writes issued
+	ui64 cells;					// Cells written (delta skips unchanged cells)
+} sOutputResult;
+
+// Present frames of pattern with strategy to console or sink (discarded if 
+//	none); frames before warm-up count are not measured
+ijk_inl void fOutputRun(sOutputResult* const result_out, eOutputPattern const pattern, eOutputPresent const present, FILE* const file, byte* const buffer, ijkConsoleColor* color, ijkConsoleColor* color_prev, ui16 const width, ui16 const height, ui32 const warmup, ui32 const frames)
+{
+	sOutputResult const reset = { 0 };
+	ijkConsole const console = { 0 };
+	ijkTimer timer[1];
+	ijkConsoleColor* swap;
+	ui32 i, f, state = 0x2545f491u, changed;
+	ui32 const count = (ui32)width * (ui32)height;
+	size_t size;
+	ui16 x, y;
+
+	*result_out = reset;
+	ijkTimerInit(timer);
+	memset(color_prev, 0xff, count * sizeof(*color_prev));
+	for (f = 0; f < warmup + frames; ++f)
+	{
+		fOutputFill(color, width, height, pattern, f, &state);
+		if (f == warmup)
+			*result_out = reset;
+		ijkTimerStart(timer);
+		switch (present)
+		{
+		case output_console:
+			for (y = 0; y < height; ++y)
+				for (x = 0; x < width; ++x)
+					ijkConsoleDrawPixel(&console, color[(ui32)y * (ui32)width + (ui32)x], (i16)x, (i16)y);
+			fflush(stdout);
+			size = (size_t)count * 2;
+			changed = count;
+			result_out->calls += (ui64)count * 3;
+			break;
+		default:
+			if (present == output_ansi)
+			{
+				size = fFrameEncode(buffer, color, width, height);
+				changed = count;
+			}
+			else
+			{
+				size = fFrameEncodeDelta(buffer, color, color_prev, width, height);
+				changed = count;
+			}
+			if (size && file)
+			{
+				fwrite(buffer, 1, size, file);
+				fflush(file);
+			}
+			result_out->calls += (size != 0);
+			break;
+		}
+		result_out->seconds += ijkTimerElapsed(timer);
+		if (present == output_delta)
+			for (i = 0, changed = 0; i < count; ++i)
+				changed += (color[i] != color_prev[i]);
+		result_out->bytes += size;
+		result_out->cells += changed;
+		swap = color_prev;
+		color_prev = color;
+		color = swap;
+	}
+}
+
+// Run output benchmark, presenting each pattern through each strategy and 
+//	reporting JSON
+//	-> encoded strategies write to the sink given with "--out" (a file or 
+//		terminal device, unbuffered so each write is one system call), or 
+//		are only encoded if there is none; the console strategy runs only 
+//		if standard output is a console, and is left out otherwise
+//	-> calls count console calls (two per cell, plus the text write) and 
+//		writes, as issued to the system
+ijk_inl iret fBenchOutput(sOptions const* const options)
+{
+	ui16 const width = options ? options->width : 0, height = options ? options->height : 0;
+	ui32 const frames = options && options->frames ? options->frames : bench_frames;
+	ui32 const warmup = options && options->frames ? options->warmup : bench_warmup;
+	ui32 const count = (ui32)width * (ui32)height;
+
+	sOutputResult result[output_patternCount][output_presentCount];
+	eOutputPattern pattern;
+	eOutputPresent present;
+	FILE* file = 0;
+	i16 w, h;
+	bool first = true;
+
+	if (!options || !count)
+		return ijk_failcode(ijk_fail_invalidparam);
+
+	bool const console = ijk_issuccess(ijkConsoleGetSize(&w, &h));
+	byte* const buffer = (byte*)malloc(fFrameEncodeCapacity(width, height));
+	ijkConsoleColor* const color = (ijkConsoleColor*)malloc((size_t)count * 2 * sizeof(*color));
+	if (!buffer || !color)
+	{
+		free(buffer);
+		free(color);
+		return ijk_failcode(ijk_fail_allocation);
+	}
+	if (options->path[0])
+	{
+		file = fFrameOpenSink(options->path, true);
+		if (!file)
+		{
+			free(buffer);
+			free(color);
+			return ijk_failcode(ijk_fail_invalidparam);
+		}
+		setvbuf(file, 0, _IONBF, 0);
+	}
+
+	for (pattern = output_solid; pattern < output_patternCount; ++pattern)
+		for (present = console ? output_console : output_ansi; present < output_presentCount; ++present)
+			fOutputRun(result[pattern] + present, pattern, present, file, buffer, color, color + count, width, height, warmup, frames);
+	if (file && file != stdout)
+		fclose(file);
+	if (console)
+	{
+		ijkConsoleResetColor();
+		ijkConsoleClear();
+	}
+
+	// report: totals are converted to means per measured frame
+	f64 const frameInv = 1.0 / (f64)frames;
+	printf("{\n");
+	printf("  \"width\": %u, \"height\": %u, \"cells\": %u, \"warmup\": %u, \"frames\": %u, \"sink\": \"%s\",\n",
+		(ui32)width, (ui32)height, count, warmup, frames, file ? options->path : "discard");
+	printf("  \"runs\": [");
+	for (pattern = output_solid; pattern < output_patternCount; ++pattern)
+	{
+		for (present = console ? output_console : output_ansi; present < output_presentCount; ++present, first = false)
+		{
+			sOutputResult const* const run = result[pattern] + present;
+			printf("%s\n    { \"pattern\": \"%s\", \"present\": \"%s\", ", first ? "" : ",", outputPatternName[pattern], outputPresentName[present]);
+			fBenchWriteNumber(stdout, "cells_per_sec", (f64)count * (f64)frames / run->seconds, run->seconds > 0.0, ", ");
+			fBenchWriteNumber(stdout, "cells_written_per_frame", (f64)run->cells * frameInv, true, ", ");
+			fBenchWriteNumber(stdout, "bytes_per_frame", (f64)run->bytes * frameInv, true, ", ");
+			fBenchWriteNumber(stdout, "syscalls_per_frame", (f64)run->calls * frameInv, present == output_console || file, ", ");
+			fBenchWriteNumber(stdout, "frame_ms", run->seconds * 1000.0 * frameInv, true, " }");
+		}
+	}
+	printf("\n  ]\n}\n");
+
+	free(buffer);
+	free(color);
+	return ijk_success;
+}
+
+
+// Replay recording headless as fast as the output path allows, reporting 
+//	JSON; frames are encoded as changes and written to the sink given with 
+//	"--out", or are only encoded if there is none, so recordings of any 
+//	scene measure decode and output alone
+ijk_inl iret fBenchReplay(sOptions const* const options)
+{
+	sReplayResult result[1];
+	iret const status = ijkPlayerReplay(0, options, result);
+	if (!ijk_issuccess(status) || !result->frames)
+	{
+		fprintf(stderr, "benchmark: replay failed \n");
+		return status;
+	}
+
+	// report: totals are converted to means per replayed frame
+	f64 const frameInv = 1.0 / (f64)result->frames;
+	printf("{\n");
+	printf("  \"width\": %u, \"height\": %u, \"frames\": %u, \"keyframes\": %u, \"sink\": \"%s\",\n",
+		(ui32)result->width, (ui32)result->height, result->frames, result->keyframes, options->path[0] ? options->path : "discard");
+	printf("  \"seconds\": %.6g, \"fps\": %.6g, \"cells_per_sec\": %.6g,\n",
+		result->seconds, (f64)result->frames / result->seconds,
+		(f64)result->width * (f64)result->height * (f64)result->frames / result->seconds);
+	printf("  \"stage_ms\": { ");
+	fBenchWriteNumber(stdout, "decode", result->msDecode * frameInv, true, ", ");
+	fBenchWriteNumber(stdout, "encode", result->msEncode * frameInv, true, ", ");
+	fBenchWriteNumber(stdout, "present", result->msPresent * frameInv, options->path[0] != 0, " },\n");
+	printf("  \"recorded_bytes_per_frame\": %.6g, \"bytes_per_frame\": %.6g\n}\n",
+		(f64)result->recorded * frameInv, (f64)result->bytes * frameInv);
+	return ijk_success;
+}
+
+
+//-----------------------------------------------------------------------------
+
+iret ijkPlayerBenchmark(kstr const args)
+{
+	iret status = -1;
+
+	// data structures for management
+	sOptions options[1];
+	sBatchResult result[1] = { 0 };
+
+	// fixed scene and range; frames are encoded and presented as they 
+	//	would be to a terminal, to the given sink if any
+	fOptionsParse(options, args);
+	if (options->bench == bench_micro)
+		return fBenchMicro(options);
+	if (options->bench == bench_output)
+		return fBenchOutput(options);
+	if (options->bench == bench_ulp)
+		return fBenchUlp(options);
+	if (options->replay[0])
+		return fBenchReplay(options);
+	if (!options->batch)
+	{
+		options->batch = true;
+		options->warmup = bench_warmup;
+		options->frameFirst = 0;
+		options->frameLast = bench_warmup + bench_frames - 1;
+	}
+	status = ijkPlayerBatch(options, true, result);
+	if (!ijk_issuccess(status) || !result->measured)
+	{
+		fprintf(stderr, "benchmark: failed \n");
+		return status;
+	}
+	if (options->perf && !fPerfStagesAny(&result->perf))
+		fprintf(stderr, "benchmark: hardware counters unavailable on this platform, timers only \n");
+
+	// report: totals are converted to means per measured frame
+	bool const staged = options->engine == engine_wavefront;
+	bool const presented = options->path[0] != 0;
+	f64 const frameInv = 1.0 / (f64)result->measured;
+	printf("{\n");
+	printf("  \"scene\": { \"layout\": \"%s\", \"spheres\": %u, \"cylinders\": %u, \"seed\": %u, \"create_ms\": %.6g },\n",
+		options->load[0] ? "file" : options->generate ? sceneLayoutName[options->scene.layout] : "default",
+		result->numSpheres, result->numCylinders, options->generate && !options->load[0] ? options->scene.seed : 0, result->msScene);
+	printf("  \"width\": %u, \"height\": %u, \"engine\": \"%s\", \"cull\": \"%s\",\n",
+		(ui32)options->width, (ui32)options->height, engineName[options->engine], cullName[options->cull]);
+	printf("  \"threads\": %u, \"cores\": %u, \"warmup\": %u, \"frames\": %u,\n",
+		result->threads, result->cores, result->frames - result->measured, result->measured);
+	printf("  \"seconds\": %.6g, \"fps\": %.6g, \"fps_per_core\": %.6g,\n",
+		result->seconds, (f64)result->measured / result->seconds, (f64)result->measured / result->seconds / (f64)result->cores);
+	printf("  \"rays\": %llu, \"rays_per_sec\": %.6g,\n",
+		(unsigned long long)result->rays, (f64)result->rays / result->seconds);
+	printf("  \"stage_ms\": { ");
+	fBenchWriteNumber(stdout, "raygen", result->msStage[wave_generate] * frameInv, staged, ", ");
+	fBenchWriteNumber(stdout, "intersect", result->msStage[wave_intersect] * frameInv, staged, ", ");
+	fBenchWriteNumber(stdout, "shade", (result->msStage[wave_compact] + result->msStage[wave_shade]) * frameInv, staged, ", ");
+	fBenchWriteNumber(stdout, "render", result->msRender * frameInv, true, ", ");
+	fBenchWriteNumber(stdout, "encode", result->msEncode * frameInv, true, ", ");
+	fBenchWriteNumber(stdout, "present", result->msPresent * frameInv, presented, " },\n");
+	printf("  \"bytes_per_frame\": %.6g,\n", (f64)result->bytes * frameInv);
+	printf("  \"frame_ms\": { \"mean\": %.6g, \"p50\": %.6g, \"p99\": %.6g, \"max\": %.6g }",
+		result->msMean, result->msP50, result->msP99, result->msMax);
+	fBenchWriteCounters(stdout, &result->counters, frameInv);
+	if (options->perf)
+	{
+		f64 const ms[perf_stageCount] = { result->msRender, result->msStage[wave_generate], result->msStage[wave_intersect],
+			result->msStage[wave_compact], result->msStage[wave_shade], result->msEncode, result->msPresent };
+		bool const measured[perf_stageCount] = { true, staged, staged, staged, staged, true, presented };
+		fBenchWritePerf(stdout, &result->perf, ms, measured, frameInv);
+	}
+	printf("\n}\n");
+
+	// done
+	return status;
+}
+
+
 //-----------------------------------------------------------------------------